@@ -3,14 +3,33 @@ precision highp float;
 varying vec2 texCoordVarying;
 
 uniform sampler2D tex0;
+uniform highp int camera_yuyv;      // tex0 holds raw YUYV, one Y0 U Y1 V pair per texel
+uniform float camera_texel_width;   // Texels across tex0
 uniform float luma_key_level;
 uniform float invert_switch;
 uniform float b_w_switch;
 uniform int luma_switch;
 
+// Camera colour at texCoords. Raw YUYV frames are converted here with the
+// BT.601 limited-range matrix; which half of the texel the pixel falls in
+// picks Y0 or Y1
+vec4 sampleCamera(vec2 texCoords) {
+    vec4 texel = texture2D(tex0, texCoords);
+    if (camera_yuyv == 0) {
+        return texel;
+    }
+    
+    float luma = fract(texCoords.x * camera_texel_width) < 0.5 ? texel.r : texel.b;
+    float y = 1.164 * (luma - 16.0 / 255.0);
+    float u = texel.g - 128.0 / 255.0;
+    float v = texel.a - 128.0 / 255.0;
+    vec3 rgb = vec3(y + 1.596 * v, y - 0.392 * u - 0.813 * v, y + 2.017 * u);
+    return vec4(clamp(rgb, 0.0, 1.0), 1.0);
+}
+
 void main() {
     // Sample the texture
-    vec4 color = texture2D(tex0, texCoordVarying);
+    vec4 color = sampleCamera(texCoordVarying);
     
     // Calculate brightness using standard luminance weights
     float bright = dot(color.rgb, vec3(0.33, 0.5, 0.16));
@@ -0,0 +1,135 @@
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+
+// X/Y/Z noise field parameters, already scaled like the CPU path;
+// each field is written to its own channel of the packed texture
+uniform vec3 theta;
+uniform vec3 resolution;
+
+// Fractal shape: octaves per field (1 = plain noise), shared ratios
+uniform vec3 octaves;
+uniform float lacunarity;
+uniform float gain;
+
+const int MAX_OCTAVES = 8;  // NoiseGenerator::MAX_OCTAVES
+
+/*
+ * 3D simplex noise
+ * Based on "webgl-noise" by Ian McEwan and Stefan Gustavson (MIT license),
+ * https://github.com/ashima/webgl-noise
+ */
+vec3 mod289(vec3 x) {
+    return x - floor(x * (1.0 / 289.0)) * 289.0;
+}
+
+vec4 mod289(vec4 x) {
+    return x - floor(x * (1.0 / 289.0)) * 289.0;
+}
+
+vec4 permute(vec4 x) {
+    return mod289(((x * 34.0) + 1.0) * x);
+}
+
+vec4 taylorInvSqrt(vec4 r) {
+    return 1.79284291400159 - 0.85373472095314 * r;
+}
+
+float snoise(vec3 v) {
+    const vec2 C = vec2(1.0 / 6.0, 1.0 / 3.0);
+    const vec4 D = vec4(0.0, 0.5, 1.0, 2.0);
+    
+    // First corner
+    vec3 i = floor(v + dot(v, C.yyy));
+    vec3 x0 = v - i + dot(i, C.xxx);
+    
+    // Other corners
+    vec3 g = step(x0.yzx, x0.xyz);
+    vec3 l = 1.0 - g;
+    vec3 i1 = min(g.xyz, l.zxy);
+    vec3 i2 = max(g.xyz, l.zxy);
+    
+    vec3 x1 = x0 - i1 + C.xxx;
+    vec3 x2 = x0 - i2 + C.yyy;
+    vec3 x3 = x0 - D.yyy;
+    
+    // Permutations
+    i = mod289(i);
+    vec4 p = permute(permute(permute(
+                 i.z + vec4(0.0, i1.z, i2.z, 1.0))
+               + i.y + vec4(0.0, i1.y, i2.y, 1.0))
+               + i.x + vec4(0.0, i1.x, i2.x, 1.0));
+    
+    // Gradients: 7x7 points over a square, mapped onto an octahedron
+    float n_ = 0.142857142857;
+    vec3 ns = n_ * D.wyz - D.xzx;
+    
+    vec4 j = p - 49.0 * floor(p * ns.z * ns.z);
+    
+    vec4 x_ = floor(j * ns.z);
+    vec4 y_ = floor(j - 7.0 * x_);
+    
+    vec4 x = x_ * ns.x + ns.yyyy;
+    vec4 y = y_ * ns.x + ns.yyyy;
+    vec4 h = 1.0 - abs(x) - abs(y);
+    
+    vec4 b0 = vec4(x.xy, y.xy);
+    vec4 b1 = vec4(x.zw, y.zw);
+    
+    vec4 s0 = floor(b0) * 2.0 + 1.0;
+    vec4 s1 = floor(b1) * 2.0 + 1.0;
+    vec4 sh = -step(h, vec4(0.0));
+    
+    vec4 a0 = b0.xzyw + s0.xzyw * sh.xxyy;
+    vec4 a1 = b1.xzyw + s1.xzyw * sh.zzww;
+    
+    vec3 p0 = vec3(a0.xy, h.x);
+    vec3 p1 = vec3(a0.zw, h.y);
+    vec3 p2 = vec3(a1.xy, h.z);
+    vec3 p3 = vec3(a1.zw, h.w);
+    
+    // Normalise gradients
+    vec4 norm = taylorInvSqrt(vec4(dot(p0, p0), dot(p1, p1), dot(p2, p2), dot(p3, p3)));
+    p0 *= norm.x;
+    p1 *= norm.y;
+    p2 *= norm.z;
+    p3 *= norm.w;
+    
+    // Same 0.6 falloff radius as ofNoise
+    vec4 m = max(0.6 - vec4(dot(x0, x0), dot(x1, x1), dot(x2, x2), dot(x3, x3)), 0.0);
+    m = m * m;
+    return 42.0 * dot(m * m, vec4(dot(p0, x0), dot(p1, x1), dot(p2, x2), dot(p3, x3)));
+}
+
+/**
+ * Normalized fBm in [-1, 1], with the same octave weights and phase offsets
+ * as the CPU fields
+ */
+float fbm(vec3 p, float octaveCount) {
+    float sum = 0.0;
+    float total = 0.0;
+    float amplitude = 1.0;
+    float frequency = 1.0;
+    for (int octave = 0; octave < MAX_OCTAVES; octave++) {
+        if (float(octave) >= octaveCount) break;
+        vec3 q = p * frequency;
+        q.z += float(octave) * 17.31;
+        sum += amplitude * snoise(q);
+        total += amplitude;
+        frequency *= lacunarity;
+        amplitude *= gain;
+    }
+    return sum / total;
+}
+
+void main() {
+    // Pixel (x, y) of the field, row 0 first like the CPU pixels
+    vec2 pixel = floor(gl_FragCoord.xy);
+    vec3 value;
+    value.r = fbm(vec3(pixel * resolution.x, theta.x), octaves.x);
+    value.g = fbm(vec3(pixel * resolution.y, theta.y), octaves.y);
+    value.b = fbm(vec3(pixel * resolution.z, theta.z), octaves.z);
+    gl_FragColor = vec4(value * 0.5 + 0.5, 1.0);
+}
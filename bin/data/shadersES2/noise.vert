@@ -0,0 +1,9 @@
+// Uniform matrices
+uniform mat4 modelViewProjectionMatrix;
+
+// Input attributes
+attribute vec4 position;
+
+void main() {
+    gl_Position = modelViewProjectionMatrix * position;
+}
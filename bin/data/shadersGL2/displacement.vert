@@ -4,9 +4,21 @@ varying vec2 texCoordVarying;
 
 // Texture samplers
 uniform sampler2D tex0;
-uniform sampler2D x_noise_image;
-uniform sampler2D y_noise_image;
-uniform sampler2D z_noise_image;
+uniform int camera_yuyv;            // tex0 holds raw YUYV, one Y0 U Y1 V pair per texel
+uniform float camera_texel_width;   // Texels across tex0
+uniform sampler2D noise_image;  // X/Y/Z noise fields packed in R/G/B
+
+// Baked noise volume stored as an atlas of slices, sliced by LFO phase
+// (NoiseVolume); the layout constants must match NoiseVolume
+uniform sampler2D noise_atlas;
+uniform int noise_volume_enabled;
+uniform vec3 x_noise_slice;
+uniform vec3 y_noise_slice;
+uniform vec3 z_noise_slice;
+
+const float ATLAS_SIZE = 96.0;      // NoiseVolume::SIZE
+const float ATLAS_COLUMNS = 12.0;   // NoiseVolume::ATLAS_COLUMNS
+const float ATLAS_TILE = 98.0;      // NoiseVolume::ATLAS_TILE
 
 // Displacement controls
 uniform vec2 xy;
@@ -41,11 +53,55 @@ uniform int bright_switch;
 uniform int width;
 uniform int height;
 
+/**
+ * Sample one slice of the noise atlas, wrapping inside its tile
+ */
+float sampleAtlasSlice(vec2 uv, float slice) {
+    vec2 tile = vec2(mod(slice, ATLAS_COLUMNS), floor(slice / ATLAS_COLUMNS));
+    vec2 texel = tile * ATLAS_TILE + 1.0 + fract(uv) * ATLAS_SIZE;
+    vec2 atlasSize = vec2(ATLAS_COLUMNS, ceil(ATLAS_SIZE / ATLAS_COLUMNS)) * ATLAS_TILE;
+    return texture2D(noise_atlas, texel / atlasSize).r;
+}
+
+/**
+ * Sample the baked noise volume for one field, blending the two nearest slices
+ */
+float sampleNoiseVolume(vec2 texCoords, vec3 slice) {
+    vec2 uv = texCoords * 0.5 * slice.xy;
+    float z = fract(slice.z) * ATLAS_SIZE - 0.5;
+    float z0 = floor(z);
+    float first = mod(z0 + ATLAS_SIZE, ATLAS_SIZE);
+    float second = mod(z0 + 1.0, ATLAS_SIZE);
+    return mix(sampleAtlasSlice(uv, first), sampleAtlasSlice(uv, second), z - z0);
+}
+
+/**
+ * Sample the X/Y/Z noise fields in one go; only the axes using a noise
+ * shape (3 = Perlin, 4 = fractal) are read, and the packed texture needs a
+ * single fetch for all three
+ */
+vec3 sampleNoiseFields(vec2 texCoords) {
+    vec3 noise = vec3(0.5);
+    if (xLfoShape < 3 && yLfoShape < 3 && zLfoShape < 3) {
+        return noise;
+    }
+    
+    if (noise_volume_enabled == 1) {
+        if (xLfoShape >= 3) noise.x = sampleNoiseVolume(texCoords, x_noise_slice);
+        if (yLfoShape >= 3) noise.y = sampleNoiseVolume(texCoords, y_noise_slice);
+        if (zLfoShape >= 3) noise.z = sampleNoiseVolume(texCoords, z_noise_slice);
+    } else {
+        noise = texture2D(noise_image, texCoords * 0.5).rgb;
+    }
+    
+    return noise;
+}
+
 /**
  * Generate oscillation based on selected waveform shape
- * Modified to accept texture coordinates as a parameter
+ * The Perlin shape uses this axis' value from sampleNoiseFields
  */
-float oscillate(float theta, int shape, int xyz, vec2 texCoords) {
+float oscillate(float theta, int shape, float noise) {
     float osc = 0.0;
     
     // Waveform selection
@@ -58,20 +114,32 @@ float oscillate(float theta, int shape, int xyz, vec2 texCoords) {
     } else if (shape == 2) {
         // Sawtooth wave
         osc = fract(theta / 6.28) * 2.0 - 1.0;
-    } else if (shape == 3) {
-        // Perlin noise from texture
-        if (xyz == 0) {
-            osc = 2.0 * (texture2D(x_noise_image, texCoords * 0.5).r - 0.5);
-        } else if (xyz == 1) {
-            osc = 2.0 * (texture2D(y_noise_image, texCoords * 0.5).r - 0.5);
-        } else {
-            osc = 2.0 * (texture2D(z_noise_image, texCoords * 0.5).r - 0.5);
-        }
+    } else if (shape >= 3) {
+        // Perlin or fractal noise from the baked volume or the per-frame
+        // texture; the fields already hold the octaves
+        osc = 2.0 * (noise - 0.5);
     }
     
     return osc;
 }
 
+// Camera colour at texCoords. Raw YUYV frames are converted here with the
+// BT.601 limited-range matrix; which half of the texel the pixel falls in
+// picks Y0 or Y1
+vec4 sampleCamera(vec2 texCoords) {
+    vec4 texel = texture2D(tex0, texCoords);
+    if (camera_yuyv == 0) {
+        return texel;
+    }
+    
+    float luma = fract(texCoords.x * camera_texel_width) < 0.5 ? texel.r : texel.b;
+    float y = 1.164 * (luma - 16.0 / 255.0);
+    float u = texel.g - 128.0 / 255.0;
+    float v = texel.a - 128.0 / 255.0;
+    vec3 rgb = vec3(y + 1.596 * v, y - 0.392 * u - 0.813 * v, y + 2.017 * u);
+    return vec4(clamp(rgb, 0.0, 1.0), 1.0);
+}
+
 void main() {
     // Pass texture coordinates to fragment shader
     texCoordVarying = gl_MultiTexCoord0.xy;
@@ -80,7 +148,7 @@ void main() {
     vec4 newPosition = ftransform();
     
     // Get brightness from texture
-    vec4 color = texture2D(tex0, texCoordVarying);
+    vec4 color = sampleCamera(texCoordVarying);
     float bright = 0.33 * color.r + 0.5 * color.g + 0.16 * color.b;
     
     // Adjust brightness with logarithmic curve for more natural feel
@@ -95,10 +163,13 @@ void main() {
     newPosition.x += xy_offset.x;
     newPosition.y += xy_offset.y;
      
+    // Every oscillator pass reads the same noise texel
+    vec3 noise = sampleNoiseFields(texCoordVarying);
+    
     // ===== First oscillator pass =====
     
     // X oscillator (first pass)
-    float xLfo = x_lfo_amp * oscillate(x_lfo_arg + newPosition.y * x_lfo_other, xLfoShape, 0, texCoordVarying);
+    float xLfo = x_lfo_amp * oscillate(x_lfo_arg + newPosition.y * x_lfo_other, xLfoShape, noise.x);
     
     // Y oscillator with possible ring modulation from X
     float yLfoAmp = y_lfo_amp;
@@ -107,7 +178,7 @@ void main() {
     float yLfoPhase = y_lfo_arg + newPosition.x * y_lfo_other;
     if (y_phasemod_switch == 1) yLfoPhase += 0.01 * xLfo;
     
-    float yLfo = yLfoAmp * oscillate(yLfoPhase, yLfoShape, 1, texCoordVarying);
+    float yLfo = yLfoAmp * oscillate(yLfoPhase, yLfoShape, noise.y);
     
     // Z oscillator with possible ring and phase modulation
     float zLfoAmp = z_lfo_amp;
@@ -120,7 +191,7 @@ void main() {
     
     if (z_phasemod_switch == 1) zLfoPhase += yLfo;
     
-    float zLfo = zLfoAmp * oscillate(zLfoPhase, zLfoShape, 2, texCoordVarying);
+    float zLfo = zLfoAmp * oscillate(zLfoPhase, zLfoShape, noise.z);
    
     // Apply Z modulation as a scaling factor
     newPosition.xy *= (1.0 - zLfo);
@@ -134,7 +205,7 @@ void main() {
     float xLfoFreq = x_lfo_arg + newPosition.y * x_lfo_other;
     if (x_phasemod_switch == 1) xLfoFreq += 10.0 * zLfo;
     
-    xLfo = xLfoAmpMod * oscillate(xLfoFreq, xLfoShape, 0, texCoordVarying);
+    xLfo = xLfoAmpMod * oscillate(xLfoFreq, xLfoShape, noise.x);
     
     // Apply brightness and X oscillator displacement
     newPosition.x += xy.x * bright + xLfo;
@@ -146,7 +217,7 @@ void main() {
     float yLfoFreq = y_lfo_arg + newPosition.x * y_lfo_other;
     if (y_phasemod_switch == 1) yLfoFreq += 0.01 * xLfo;
     
-    yLfo = yLfoAmpMod * oscillate(yLfoFreq, yLfoShape, 1, texCoordVarying);
+    yLfo = yLfoAmpMod * oscillate(yLfoFreq, yLfoShape, noise.y);
     
     // Apply brightness and Y oscillator displacement
     newPosition.y += xy.y * bright + yLfo;
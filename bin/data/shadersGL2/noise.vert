@@ -0,0 +1,5 @@
+OF_GLSL_SHADER_HEADER
+
+void main() {
+    gl_Position = ftransform();
+}
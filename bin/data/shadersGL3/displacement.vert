@@ -12,9 +12,16 @@ uniform mat4 modelViewProjectionMatrix;
 
 // Texture samplers
 uniform sampler2D tex0;
-uniform sampler2D x_noise_image;
-uniform sampler2D y_noise_image;
-uniform sampler2D z_noise_image;
+uniform int camera_yuyv;            // tex0 holds raw YUYV, one Y0 U Y1 V pair per texel
+uniform float camera_texel_width;   // Texels across tex0
+uniform sampler2D noise_image;  // X/Y/Z noise fields packed in R/G/B
+
+// Baked noise volume, sliced by LFO phase (NoiseVolume)
+uniform sampler3D noise_volume;
+uniform int noise_volume_enabled;
+uniform vec3 x_noise_slice;
+uniform vec3 y_noise_slice;
+uniform vec3 z_noise_slice;
 
 // Displacement controls
 uniform vec2 xy;
@@ -49,11 +56,64 @@ uniform int bright_switch;
 uniform int width;
 uniform int height;
 
+// Procedural grid controls (attribute-less draw)
+uniform int procedural_grid;
+uniform int grid_type;
+uniform int grid_resolution;
+
+// Instanced grid controls (unit cell drawn once per grid cell)
+uniform int instanced_grid;
+uniform int grid_skip_cells;
+
+/**
+ * Rebuild a grid vertex from gl_VertexID and gl_InstanceID
+ * Triangle grids are drawn as one strip per row, line grids as one strip
+ * per row (horizontal) or column (vertical)
+ */
+vec2 gridCell() {
+    if (grid_type == 0) {
+        // Strip alternates bottom and top points of the row
+        return vec2(gl_VertexID / 2, gl_InstanceID + 1 - gl_VertexID % 2);
+    } else if (grid_type == 1) {
+        return vec2(gl_VertexID, gl_InstanceID);
+    }
+    return vec2(gl_InstanceID, gl_VertexID);
+}
+
+/**
+ * Sample the baked noise volume for one field
+ */
+float sampleNoiseVolume(vec2 texCoords, vec3 slice) {
+    return texture(noise_volume, vec3(texCoords * 0.5 * slice.xy, slice.z)).r;
+}
+
+/**
+ * Sample the X/Y/Z noise fields in one go; only the axes using a noise
+ * shape (3 = Perlin, 4 = fractal) are read, and the packed texture needs a
+ * single fetch for all three
+ */
+vec3 sampleNoiseFields(vec2 texCoords) {
+    vec3 noise = vec3(0.5);
+    if (xLfoShape < 3 && yLfoShape < 3 && zLfoShape < 3) {
+        return noise;
+    }
+    
+    if (noise_volume_enabled == 1) {
+        if (xLfoShape >= 3) noise.x = sampleNoiseVolume(texCoords, x_noise_slice);
+        if (yLfoShape >= 3) noise.y = sampleNoiseVolume(texCoords, y_noise_slice);
+        if (zLfoShape >= 3) noise.z = sampleNoiseVolume(texCoords, z_noise_slice);
+    } else {
+        noise = texture(noise_image, texCoords * 0.5).rgb;
+    }
+    
+    return noise;
+}
+
 /**
  * Generate oscillation based on selected waveform shape
- * Modified to accept texture coordinates as a parameter
+ * The Perlin shape uses this axis' value from sampleNoiseFields
  */
-float oscillate(float theta, int shape, int xyz, vec2 texCoords) {
+float oscillate(float theta, int shape, float noise) {
     float osc = 0.0;
     
     // Waveform selection
@@ -66,29 +126,63 @@ float oscillate(float theta, int shape, int xyz, vec2 texCoords) {
     } else if (shape == 2) {
         // Sawtooth wave
         osc = fract(theta / 6.28) * 2.0 - 1.0;
-    } else if (shape == 3) {
-        // Perlin noise from texture
-        if (xyz == 0) {
-            osc = 2.0 * (texture(x_noise_image, texCoords * 0.5).r - 0.5);
-        } else if (xyz == 1) {
-            osc = 2.0 * (texture(y_noise_image, texCoords * 0.5).r - 0.5);
-        } else {
-            osc = 2.0 * (texture(z_noise_image, texCoords * 0.5).r - 0.5);
-        }
+    } else if (shape >= 3) {
+        // Perlin or fractal noise from the baked volume or the per-frame
+        // texture; the fields already hold the octaves
+        osc = 2.0 * (noise - 0.5);
     }
     
     return osc;
 }
 
+// Camera colour at texCoords. Raw YUYV frames are converted here with the
+// BT.601 limited-range matrix; which half of the texel the pixel falls in
+// picks Y0 or Y1
+vec4 sampleCamera(vec2 texCoords) {
+    vec4 texel = texture(tex0, texCoords);
+    if (camera_yuyv == 0) {
+        return texel;
+    }
+    
+    float luma = fract(texCoords.x * camera_texel_width) < 0.5 ? texel.r : texel.b;
+    float y = 1.164 * (luma - 16.0 / 255.0);
+    float u = texel.g - 128.0 / 255.0;
+    float v = texel.a - 128.0 / 255.0;
+    vec3 rgb = vec3(y + 1.596 * v, y - 0.392 * u - 0.813 * v, y + 2.017 * u);
+    return vec4(clamp(rgb, 0.0, 1.0), 1.0);
+}
+
 void main() {
+    vec4 basePosition = position;
+    vec2 baseTexCoord = texcoord;
+    
+    // Generate the grid vertex when no attributes are bound
+    if (procedural_grid == 1) {
+        baseTexCoord = gridCell() / float(grid_resolution);
+        basePosition = vec4(baseTexCoord * vec2(width, height), 0.0, 1.0);
+    } else if (instanced_grid == 1) {
+        int column = gl_InstanceID % grid_resolution;
+        int row = gl_InstanceID / grid_resolution;
+        vec2 corner = position.xy;
+        
+        // Performance mode keeps the second triangle only in even cells,
+        // elsewhere it collapses to a point and is culled
+        if (grid_skip_cells == 1 && position.z > 0.5 && (column % 2 == 1 || row % 2 == 1)) {
+            corner = vec2(0.0);
+        }
+        
+        baseTexCoord = (vec2(column, row) + corner) / float(grid_resolution);
+        basePosition = vec4(baseTexCoord * vec2(width, height), 0.0, 1.0);
+    }
+    
     // Pass texture coordinates to fragment shader
-    texCoordVarying = texcoord;
+    texCoordVarying = baseTexCoord;
 
     // Calculate base position
-    vec4 newPosition = modelViewProjectionMatrix * position;
+    vec4 newPosition = modelViewProjectionMatrix * basePosition;
     
     // Get brightness from texture
-    vec4 color = texture(tex0, texCoordVarying);
+    vec4 color = sampleCamera(texCoordVarying);
     float bright = 0.33 * color.r + 0.5 * color.g + 0.16 * color.b;
     
     // Adjust brightness with logarithmic curve for more natural feel
@@ -103,10 +197,13 @@ void main() {
     newPosition.x += xy_offset.x;
     newPosition.y += xy_offset.y;
      
+    // Every oscillator pass reads the same noise texel
+    vec3 noise = sampleNoiseFields(texCoordVarying);
+    
     // ===== First oscillator pass =====
     
     // X oscillator (first pass)
-    float xLfo = x_lfo_amp * oscillate(x_lfo_arg + newPosition.y * x_lfo_other, xLfoShape, 0, texCoordVarying);
+    float xLfo = x_lfo_amp * oscillate(x_lfo_arg + newPosition.y * x_lfo_other, xLfoShape, noise.x);
     
     // Y oscillator with possible ring modulation from X
     float yLfoAmp = y_lfo_amp;
@@ -115,7 +212,7 @@ void main() {
     float yLfoPhase = y_lfo_arg + newPosition.x * y_lfo_other;
     if (y_phasemod_switch == 1) yLfoPhase += 0.01 * xLfo;
     
-    float yLfo = yLfoAmp * oscillate(yLfoPhase, yLfoShape, 1, texCoordVarying);
+    float yLfo = yLfoAmp * oscillate(yLfoPhase, yLfoShape, noise.y);
     
     // Z oscillator with possible ring and phase modulation
     float zLfoAmp = z_lfo_amp;
@@ -128,7 +225,7 @@ void main() {
     
     if (z_phasemod_switch == 1) zLfoPhase += yLfo;
     
-    float zLfo = zLfoAmp * oscillate(zLfoPhase, zLfoShape, 2, texCoordVarying);
+    float zLfo = zLfoAmp * oscillate(zLfoPhase, zLfoShape, noise.z);
    
     // Apply Z modulation as a scaling factor
     newPosition.xy *= (1.0 - zLfo);
@@ -142,7 +239,7 @@ void main() {
     float xLfoFreq = x_lfo_arg + newPosition.y * x_lfo_other;
     if (x_phasemod_switch == 1) xLfoFreq += 10.0 * zLfo;
     
-    xLfo = xLfoAmpMod * oscillate(xLfoFreq, xLfoShape, 0, texCoordVarying);
+    xLfo = xLfoAmpMod * oscillate(xLfoFreq, xLfoShape, noise.x);
     
     // Apply brightness and X oscillator displacement
     newPosition.x += xy.x * bright + xLfo;
@@ -154,7 +251,7 @@ void main() {
     float yLfoFreq = y_lfo_arg + newPosition.x * y_lfo_other;
     if (y_phasemod_switch == 1) yLfoFreq += 0.01 * xLfo;
     
-    yLfo = yLfoAmpMod * oscillate(yLfoFreq, yLfoShape, 1, texCoordVarying);
+    yLfo = yLfoAmpMod * oscillate(yLfoFreq, yLfoShape, noise.y);
     
     // Apply brightness and Y oscillator displacement
     newPosition.y += xy.y * bright + yLfo;
@@ -0,0 +1,11 @@
+OF_GLSL_SHADER_HEADER
+
+// Input attributes
+in vec4 position;
+
+// Uniform matrices
+uniform mat4 modelViewProjectionMatrix;
+
+void main() {
+    gl_Position = modelViewProjectionMatrix * position;
+}
@@ -0,0 +1,102 @@
+#include "CaptureThread.h"
+
+CaptureThread::CaptureThread()
+    : backSlot(0), frontSlot(1), middleSlot(2), running(false),
+      capturedFrames(0), droppedFrames(0), duplicatedFrames(0) {
+    for (auto& sequence : sequences) {
+        sequence = 0;
+    }
+}
+
+CaptureThread::~CaptureThread() {
+    stop();
+}
+
+void CaptureThread::start(GrabFunction grabFunction) {
+    stop();
+    
+    grab = grabFunction;
+    backSlot = 0;
+    frontSlot = 1;
+    middleSlot = 2;
+    for (auto& sequence : sequences) {
+        sequence = 0;
+    }
+    resetCounters();
+    
+    running = true;
+    thread = std::thread(&CaptureThread::threadFunction, this);
+}
+
+void CaptureThread::stop() {
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+    grab = nullptr;
+}
+
+bool CaptureThread::isRunning() const {
+    return running;
+}
+
+bool CaptureThread::update() {
+    if (!(middleSlot.load(std::memory_order_acquire) & NEW_FRAME)) {
+        if (running) {
+            duplicatedFrames++;
+        }
+        return false;
+    }
+    
+    // The capture thread may have published again since the check; the
+    // exchange still hands back whichever frame is newest
+    frontSlot = middleSlot.exchange(frontSlot, std::memory_order_acq_rel) & SLOT_MASK;
+    return true;
+}
+
+const ofPixels& CaptureThread::getFrame() const {
+    return slots[frontSlot];
+}
+
+uint64_t CaptureThread::getFrameSequence() const {
+    return sequences[frontSlot];
+}
+
+void CaptureThread::addDroppedFrames(uint64_t count) {
+    droppedFrames += count;
+}
+
+uint64_t CaptureThread::getCapturedFrames() const {
+    return capturedFrames;
+}
+
+uint64_t CaptureThread::getDroppedFrames() const {
+    return droppedFrames;
+}
+
+uint64_t CaptureThread::getDuplicatedFrames() const {
+    return duplicatedFrames;
+}
+
+void CaptureThread::resetCounters() {
+    capturedFrames = 0;
+    droppedFrames = 0;
+    duplicatedFrames = 0;
+}
+
+void CaptureThread::threadFunction() {
+    while (running) {
+        if (!grab(slots[backSlot])) continue;
+        
+        // The exchange below publishes the sequence number with the pixels
+        sequences[backSlot] = ++capturedFrames;
+        
+        // Publish the back slot and take over the previous middle one; if
+        // that was never taken, the frame in it is dropped
+        int previous = middleSlot.exchange(backSlot | NEW_FRAME, std::memory_order_acq_rel);
+        backSlot = previous & SLOT_MASK;
+        if (previous & NEW_FRAME) {
+            droppedFrames++;
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "ofMain.h"
+#include <thread>
+#include <atomic>
+#include <functional>
+
+// Runs camera capture on its own thread so a slow or late device never
+// stalls the render loop. Frames are handed over through a lock-free triple
+// buffer: the capture thread fills a back slot and swaps it with the middle
+// one, and the render thread swaps the middle slot into the front whenever a
+// newer frame is there. Neither side ever waits for the other, and the front
+// slot always holds the newest complete frame.
+class CaptureThread {
+public:
+    // Called on the capture thread to fill the pixels with the next frame.
+    // Returns false when no frame arrived; it should wait a little for one
+    // first, since the thread calls it again straight away
+    typedef std::function<bool(ofPixels& pixels)> GrabFunction;
+    
+    CaptureThread();
+    ~CaptureThread();
+    
+    void start(GrabFunction grab);
+    void stop();
+    bool isRunning() const;
+    
+    // Render thread: take the newest published frame, if there is one since
+    // the last call. Counts a duplicated frame when there isn't
+    bool update();
+    
+    // The frame update() last took; only touched by the render thread
+    const ofPixels& getFrame() const;
+    
+    // Sequence number of that frame, counting from 1 since start(); 0 until
+    // the first frame arrives. Consumers compare it with the last one they
+    // used, so each frame is consumed exactly once
+    uint64_t getFrameSequence() const;
+    
+    // Frames lost upstream (e.g. gaps in the driver's sequence numbers);
+    // safe to call from the grab function
+    void addDroppedFrames(uint64_t count);
+    
+    uint64_t getCapturedFrames() const;
+    uint64_t getDroppedFrames() const;      // Captured or lost, never shown
+    uint64_t getDuplicatedFrames() const;   // Render updates that reused the previous frame
+    void resetCounters();
+
+private:
+    void threadFunction();
+    
+    // Slot index in the low bits, with a flag for a frame not yet taken
+    static constexpr int SLOT_MASK = 3;
+    static constexpr int NEW_FRAME = 4;
+    
+    ofPixels slots[3];
+    uint64_t sequences[3];          // Published along with each slot
+    int backSlot;                   // Capture thread only
+    int frontSlot;                  // Render thread only
+    std::atomic<int> middleSlot;
+    
+    GrabFunction grab;
+    std::thread thread;
+    std::atomic<bool> running;
+    
+    std::atomic<uint64_t> capturedFrames;
+    std::atomic<uint64_t> droppedFrames;
+    uint64_t duplicatedFrames;      // Render thread only
+};
@@ -1,196 +1,743 @@
 #include "MeshGenerator.h"
 
 MeshGenerator::MeshGenerator(ParameterManager* paramManager)
-    : paramManager(paramManager), width(0), height(0) {
+    : paramManager(paramManager), width(0), height(0),
+      cacheBytes(0), cacheHits(0), cacheMisses(0) {
+}
+
+MeshGenerator::~MeshGenerator() {
+    // Stop the background generator before the mesh data goes away
+    {
+        std::lock_guard<std::mutex> lock(generatorMutex);
+        stopGenerator = true;
+    }
+    generatorCondition.notify_all();
+    
+    if (generatorThread.joinable()) {
+        generatorThread.join();
+    }
+    
+#ifndef TARGET_OPENGLES
+    if (proceduralVao != 0) {
+        glDeleteVertexArrays(1, &proceduralVao);
+    }
+#endif
 }
 
 void MeshGenerator::setup(int canvasWidth, int canvasHeight) {
     width = canvasWidth;
     height = canvasHeight;
     
-    // Generate initial mesh based on default settings
-    updateMeshFromParameters();
+    // Generate the initial mesh synchronously so there is always something to draw
+    currentKey = getKeyFromParameters();
+    desiredKey = currentKey;
+    
+    currentMesh = std::make_shared<ChunkedMesh>();
+    generateMesh(currentKey, *currentMesh);
+    addToCache(currentKey, currentMesh);
+    
+    lastRevision = paramManager->getMeshRevision();
+    lastResolutionLimit = resolutionLimit;
+    rebuildWindowStart = ofGetElapsedTimef();
+    
+    // Later rebuilds happen on the background generator thread
+    if (!generatorThread.joinable()) {
+        generatorThread = std::thread(&MeshGenerator::generatorThreadFunction, this);
+    }
 }
 
 void MeshGenerator::update() {
-    // Check if mesh needs updating
-    int currentScale = paramManager->getScale();
-    MeshType currentMeshType = paramManager->getMeshType();
+    // Swap in any mesh the background thread has finished
+    applyGeneratedMesh();
     
-    if (currentScale != lastScale || currentMeshType != lastMeshType) {
+    // Only look at the parameters again when something mesh related changed
+    unsigned int revision = paramManager->getMeshRevision();
+    if (revision != lastRevision || resolutionLimit != lastResolutionLimit) {
+        lastRevision = revision;
+        lastResolutionLimit = resolutionLimit;
         updateMeshFromParameters();
-        lastScale = currentScale;
-        lastMeshType = currentMeshType;
-        needsUpdate = false;
+    }
+    
+    float now = ofGetElapsedTimef();
+    if (now - rebuildWindowStart >= 1.0f) {
+        rebuildsPerSecond = rebuildCount;
+        rebuildCount = 0;
+        rebuildWindowStart = now;
     }
 }
 
-void MeshGenerator::updateMeshFromParameters() {
+MeshGenerator::MeshKey MeshGenerator::getKeyFromParameters() const {
     int resolution = paramManager->getScale();
     bool performanceMode = paramManager->isPerformanceModeEnabled();
     
-    // In performance mode, limit the resolution if it's higher than the performance scale
-    if (performanceMode) {
+    if (paramManager->isAdaptiveResolutionEnabled()) {
+        // The adaptive controller replaces the static performance clamp
+        if (resolutionLimit > 0 && resolution > resolutionLimit) {
+            resolution = resolutionLimit;
+        }
+    } else if (performanceMode) {
+        // In performance mode, limit the resolution if it's higher than the performance scale
         int performanceScale = paramManager->getPerformanceScale();
         if (resolution > performanceScale) {
             resolution = performanceScale;
         }
     }
     
-    switch (paramManager->getMeshType()) {
-        case MeshType::TriangleGrid:
-        case MeshType::TriangleWireframe:
-            generateTriangleMesh(resolution);
-            break;
+    // Wireframe draws the same triangles, so both share one cache entry
+    MeshType meshType = paramManager->getMeshType();
+    if (meshType == MeshType::TriangleWireframe) {
+        meshType = MeshType::TriangleGrid;
+    }
+    
+    return {meshType, resolution, width, height, performanceMode, isPrimitiveRestartSupported()};
+}
+
+void MeshGenerator::updateMeshFromParameters() {
+    applyGeneratedMesh();
+    
+    MeshKey key = getKeyFromParameters();
+    desiredKey = key;
+    
+    // Procedural and instanced grids are built in the vertex shader, nothing to generate
+    if (getActiveRenderMode() != MeshRenderMode::VertexBuffer) {
+        return;
+    }
+    
+    if (key == currentKey) {
+        return;
+    }
+    
+    // Reuse an already uploaded mesh if we have one for these settings
+    for (auto it = meshCache.begin(); it != meshCache.end(); ++it) {
+        if (it->key == key) {
+            // Move to the front so it is the last to be evicted
+            meshCache.splice(meshCache.begin(), meshCache, it);
+            currentMesh = meshCache.front().mesh;
+            currentKey = key;
+            cacheHits++;
+            return;
+        }
+    }
+    
+    // Already being built, keep drawing the previous mesh until it's done
+    if (generationInFlight && inFlightKey == key) {
+        return;
+    }
+    
+    cacheMisses++;
+    requestMesh(key);
+}
+
+void MeshGenerator::setResolutionLimit(int limit) {
+    resolutionLimit = limit;
+}
+
+int MeshGenerator::getResolution() const {
+    return desiredKey.resolution;
+}
+
+void MeshGenerator::requestMesh(const MeshKey& key) {
+    {
+        // A newer request replaces one the thread hasn't picked up yet
+        std::lock_guard<std::mutex> lock(generatorMutex);
+        pendingKey = key;
+        hasPendingRequest = true;
+    }
+    generatorCondition.notify_one();
+    
+    generationInFlight = true;
+    inFlightKey = key;
+    rebuildCount++;
+}
+
+void MeshGenerator::applyGeneratedMesh() {
+    std::shared_ptr<ChunkedMesh> finishedMesh;
+    MeshKey key;
+    
+    {
+        std::lock_guard<std::mutex> lock(generatorMutex);
+        if (!hasGeneratedMesh) {
+            return;
+        }
+        finishedMesh = std::move(generatedMesh);
+        key = generatedKey;
+        hasGeneratedMesh = false;
+    }
+    
+    if (generationInFlight && inFlightKey == key) {
+        generationInFlight = false;
+    }
+    
+    // Upload happens on first draw, here on the GL thread
+    addToCache(key, finishedMesh);
+    
+    // Results for settings that were already changed again stay cached only
+    if (key == desiredKey) {
+        currentMesh = finishedMesh;
+        currentKey = key;
+    }
+}
+
+void MeshGenerator::generatorThreadFunction() {
+    while (true) {
+        MeshKey key;
+        
+        {
+            std::unique_lock<std::mutex> lock(generatorMutex);
+            generatorCondition.wait(lock, [this] {
+                return stopGenerator || hasPendingRequest;
+            });
             
-        case MeshType::HorizontalLines:
-            generateHorizontalLineMesh(resolution);
-            break;
+            if (stopGenerator) {
+                return;
+            }
             
-        case MeshType::VerticalLines:
-            generateVerticalLineMesh(resolution);
-            break;
+            key = pendingKey;
+            hasPendingRequest = false;
+        }
+        
+        // Build straight into the mesh the GL thread will draw, no GL calls
+        // happen until its first draw so this is safe off the GL thread
+        std::shared_ptr<ChunkedMesh> backBuffer = std::make_shared<ChunkedMesh>();
+        generateMesh(key, *backBuffer);
+        
+        {
+            std::lock_guard<std::mutex> lock(generatorMutex);
+            generatedMesh = std::move(backBuffer);
+            generatedKey = key;
+            hasGeneratedMesh = true;
+        }
     }
 }
 
-void MeshGenerator::clearMesh() {
-    mesh.clear();
+void MeshGenerator::addToCache(const MeshKey& key, std::shared_ptr<ChunkedMesh> mesh) {
+    CachedMesh entry;
+    entry.key = key;
+    entry.mesh = mesh;
+    entry.bytes = getMeshBytes(*mesh);
+    
+    meshCache.push_front(entry);
+    cacheBytes += entry.bytes;
+    
+    evictCachedMeshes();
 }
 
-void MeshGenerator::generateTriangleMesh(int resolution) {
-    clearMesh();
+void MeshGenerator::evictCachedMeshes() {
+    size_t budget = (size_t)paramManager->getMeshCacheSize() * 1024 * 1024;
     
-    float rescale = 1.0f / resolution;
-    bool performanceMode = paramManager->isPerformanceModeEnabled();
+    // Drop least recently used meshes, the one being drawn stays alive through currentMesh
+    while (cacheBytes > budget && meshCache.size() > 1) {
+        cacheBytes -= meshCache.back().bytes;
+        meshCache.pop_back();
+    }
+}
+
+size_t MeshGenerator::getMeshBytes(const ChunkedMesh& source) const {
+    size_t bytes = 0;
+    for (const MeshChunk& chunk : source) {
+        bytes += chunk.mesh.getNumVertices() * sizeof(glm::vec3)
+               + chunk.mesh.getNumTexCoords() * sizeof(glm::vec2)
+               + chunk.mesh.getNumIndices() * sizeof(ofIndexType);
+    }
+    return bytes;
+}
+
+int MeshGenerator::getCacheSize() const {
+    return meshCache.size();
+}
+
+size_t MeshGenerator::getCacheBytes() const {
+    return cacheBytes;
+}
+
+int MeshGenerator::getCacheHits() const {
+    return cacheHits;
+}
+
+int MeshGenerator::getCacheMisses() const {
+    return cacheMisses;
+}
+
+int MeshGenerator::getRebuildsPerSecond() const {
+    return rebuildsPerSecond;
+}
+
+void MeshGenerator::generateMesh(const MeshKey& key, ChunkedMesh& target) {
+    // Line meshes run at double resolution
+    bool lines = key.type == MeshType::HorizontalLines || key.type == MeshType::VerticalLines;
+    int cells = lines ? key.resolution * 2 : key.resolution;
+    int chunksPerSide = (cells + CHUNK_CELLS - 1) / CHUNK_CELLS;
     
-    // Create triangular mesh using vertices and texture coordinates
-    for (int i = 0; i < resolution; i++) {
-        for (int j = 0; j < resolution; j++) {
-            // Calculate vertex positions
-            float x0 = j * width / (float)resolution;
-            float x1 = (j + 1) * width / (float)resolution;
-            float y0 = i * height / (float)resolution;
-            float y1 = (i + 1) * height / (float)resolution;
-            
-            ofVec3f vertex1(x0, y0, 0);
-            ofVec3f vertex2(x1, y0, 0);
-            ofVec3f vertex3(x1, y1, 0);
-            ofVec3f vertex4(x0, y1, 0);
+    target.clear();
+    target.resize((size_t)chunksPerSide * chunksPerSide);
+    
+    // Split the grid into blocks that each fit 16-bit indices
+    for (int chunkRow = 0; chunkRow < chunksPerSide; chunkRow++) {
+        for (int chunkColumn = 0; chunkColumn < chunksPerSide; chunkColumn++) {
+            ChunkRange range;
+            range.firstColumn = chunkColumn * CHUNK_CELLS;
+            range.firstRow = chunkRow * CHUNK_CELLS;
+            range.columns = std::min(CHUNK_CELLS, cells - range.firstColumn);
+            range.rows = std::min(CHUNK_CELLS, cells - range.firstRow);
             
-            // Calculate texture coordinates
-            float tex_x0 = j * rescale;
-            float tex_x1 = (j + 1) * rescale;
-            float tex_y0 = i * rescale;
-            float tex_y1 = (i + 1) * rescale;
+            MeshChunk& chunk = target[chunkRow * chunksPerSide + chunkColumn];
+            chunk.bounds = ofRectangle(range.firstColumn * key.width / (float)cells,
+                                       range.firstRow * key.height / (float)cells,
+                                       range.columns * key.width / (float)cells,
+                                       range.rows * key.height / (float)cells);
             
-            ofVec2f texCoord1(tex_x0, tex_y0);
-            ofVec2f texCoord2(tex_x1, tex_y0);
-            ofVec2f texCoord3(tex_x1, tex_y1);
-            ofVec2f texCoord4(tex_x0, tex_y1);
+            switch (key.type) {
+                case MeshType::TriangleGrid:
+                case MeshType::TriangleWireframe:
+                    generateTriangleChunk(key, range, chunk.mesh);
+                    break;
+                    
+                case MeshType::HorizontalLines:
+                    generateHorizontalLineChunk(key, range, chunk.mesh);
+                    break;
+                    
+                case MeshType::VerticalLines:
+                    generateVerticalLineChunk(key, range, chunk.mesh);
+                    break;
+            }
+        }
+    }
+}
+
+void MeshGenerator::generateTriangleChunk(const MeshKey& key, const ChunkRange& range, ofMesh& target) {
+    int resolution = key.resolution;
+    int width = key.width;
+    int height = key.height;
+    
+    target.clear();
+    
+    float rescale = 1.0f / resolution;
+    bool performanceMode = key.performanceMode;
+    int columns = range.columns + 1;
+    size_t gridVertices = (size_t)columns * (range.rows + 1);
+    
+    // Performance mode keeps the second triangle only in even rows and columns
+    size_t cells = (size_t)range.columns * range.rows;
+    size_t secondTriangles = performanceMode
+        ? countEven(range.firstColumn, range.columns) * countEven(range.firstRow, range.rows)
+        : cells;
+    
+    // Size the arrays once and fill them in place
+    std::vector<glm::vec3>& vertices = target.getVertices();
+    std::vector<glm::vec2>& texCoords = target.getTexCoords();
+    std::vector<ofIndexType>& indices = target.getIndices();
+    vertices.resize(gridVertices);
+    texCoords.resize(gridVertices);
+    indices.resize((cells + secondTriangles) * 3);
+    
+    glm::vec3* vertex = vertices.data();
+    glm::vec2* texCoord = texCoords.data();
+    ofIndexType* index = indices.data();
+    
+    // One vertex per grid point, shared by all neighbouring triangles so the
+    // GPU can reuse displaced vertices from its post-transform cache
+    for (int i = range.firstRow; i <= range.firstRow + range.rows; i++) {
+        float y = i * height / (float)resolution;
+        float v = i * rescale;
+        
+        for (int j = range.firstColumn; j <= range.firstColumn + range.columns; j++) {
+            *vertex++ = glm::vec3(j * width / (float)resolution, y, 0);
+            *texCoord++ = glm::vec2(j * rescale, v);
+        }
+    }
+    
+    // Two triangles per cell, referencing the shared grid vertices
+    for (int row = 0; row < range.rows; row++) {
+        for (int column = 0; column < range.columns; column++) {
+            ofIndexType topLeft = row * columns + column;
+            ofIndexType topRight = topLeft + 1;
+            ofIndexType bottomLeft = topLeft + columns;
+            ofIndexType bottomRight = bottomLeft + 1;
             
             // First triangle (top-left, top-right, bottom-right)
-            mesh.addVertex(vertex1);
-            mesh.addVertex(vertex2);
-            mesh.addVertex(vertex3);
-            
-            mesh.addTexCoord(texCoord1);
-            mesh.addTexCoord(texCoord2);
-            mesh.addTexCoord(texCoord3);
+            *index++ = topLeft;
+            *index++ = topRight;
+            *index++ = bottomRight;
             
             // In performance mode, optimize by using only one triangle per cell
+            int i = range.firstRow + row;
+            int j = range.firstColumn + column;
             if (!performanceMode || (i % 2 == 0 && j % 2 == 0)) {
                 // Second triangle (bottom-right, bottom-left, top-left)
-                mesh.addVertex(vertex3);
-                mesh.addVertex(vertex4);
-                mesh.addVertex(vertex1);
-                
-                mesh.addTexCoord(texCoord3);
-                mesh.addTexCoord(texCoord4);
-                mesh.addTexCoord(texCoord1);
+                *index++ = bottomRight;
+                *index++ = bottomLeft;
+                *index++ = topLeft;
             }
         }
     }
     
-    mesh.setMode(OF_PRIMITIVE_TRIANGLES);
-    vboMesh = mesh;
+    target.setMode(OF_PRIMITIVE_TRIANGLES);
+}
+
+size_t MeshGenerator::countEven(int first, int count) {
+    return (size_t)((first + count + 1) / 2 - (first + 1) / 2);
 }
 
-void MeshGenerator::generateHorizontalLineMesh(int resolution) {
-    clearMesh();
+void MeshGenerator::generateHorizontalLineChunk(const MeshKey& key, const ChunkRange& range, ofMesh& target) {
+    int width = key.width;
+    int height = key.height;
+    
+    target.clear();
     
-    int doubledResolution = resolution * 2;
+    int doubledResolution = key.resolution * 2;
     float rescale = 1.0f / doubledResolution;
     
-    // Create horizontal line mesh
-    for (int i = 0; i < doubledResolution; i++) {
-        for (int j = 0; j < doubledResolution; j++) {
-            // Calculate vertex positions
-            int x0 = j * width / doubledResolution;
-            int x1 = (j + 1) * width / doubledResolution;
-            int y0 = i * height / doubledResolution;
-            
-            ofVec3f vertex1(x0, y0, 0);
-            ofVec3f vertex2(x1, y0, 0);
-            
-            // Calculate texture coordinates
-            float tex_x0 = j * rescale;
-            float tex_x1 = (j + 1) * rescale;
-            float tex_y0 = i * rescale;
-            
-            ofVec2f texCoord1(tex_x0, tex_y0);
-            ofVec2f texCoord2(tex_x1, tex_y0);
-            
-            // Add line segment
-            mesh.addVertex(vertex1);
-            mesh.addVertex(vertex2);
+    // One line per row of the chunk, neighbouring segments share their end points
+    int pointsPerLine = range.columns + 1;
+    size_t lineVertices = (size_t)range.rows * pointsPerLine;
+    
+    std::vector<glm::vec3>& vertices = target.getVertices();
+    std::vector<glm::vec2>& texCoords = target.getTexCoords();
+    vertices.resize(lineVertices);
+    texCoords.resize(lineVertices);
+    
+    glm::vec3* vertex = vertices.data();
+    glm::vec2* texCoord = texCoords.data();
+    
+    for (int i = range.firstRow; i < range.firstRow + range.rows; i++) {
+        int y = i * height / doubledResolution;
+        float v = i * rescale;
+        
+        for (int j = range.firstColumn; j <= range.firstColumn + range.columns; j++) {
+            int x = j * width / doubledResolution;
             
-            mesh.addTexCoord(texCoord1);
-            mesh.addTexCoord(texCoord2);
+            *vertex++ = glm::vec3(x, y, 0);
+            *texCoord++ = glm::vec2(j * rescale, v);
         }
     }
     
-    mesh.setMode(OF_PRIMITIVE_LINES);
-    vboMesh = mesh;
+    addLineIndices(key, range.rows, pointsPerLine, target);
 }
 
-void MeshGenerator::generateVerticalLineMesh(int resolution) {
-    clearMesh();
+void MeshGenerator::generateVerticalLineChunk(const MeshKey& key, const ChunkRange& range, ofMesh& target) {
+    int width = key.width;
+    int height = key.height;
     
-    int doubledResolution = resolution * 2;
+    target.clear();
+    
+    int doubledResolution = key.resolution * 2;
     float rescale = 1.0f / doubledResolution;
     
-    // Create vertical line mesh
-    for (int i = 0; i < doubledResolution; i++) {
-        for (int j = 0; j < doubledResolution; j++) {
-            // Calculate vertex positions
-            int x0 = i * width / doubledResolution;
-            int y0 = j * height / doubledResolution;
-            int y1 = (j + 1) * height / doubledResolution;
-            
-            ofVec3f vertex1(x0, y0, 0);
-            ofVec3f vertex2(x0, y1, 0);
-            
-            // Calculate texture coordinates
-            float tex_x0 = i * rescale;
-            float tex_y0 = j * rescale;
-            float tex_y1 = (j + 1) * rescale;
+    // Same sharing as the horizontal lines, one column of the chunk at a time
+    int pointsPerLine = range.rows + 1;
+    size_t lineVertices = (size_t)range.columns * pointsPerLine;
+    
+    std::vector<glm::vec3>& vertices = target.getVertices();
+    std::vector<glm::vec2>& texCoords = target.getTexCoords();
+    vertices.resize(lineVertices);
+    texCoords.resize(lineVertices);
+    
+    glm::vec3* vertex = vertices.data();
+    glm::vec2* texCoord = texCoords.data();
+    
+    for (int i = range.firstColumn; i < range.firstColumn + range.columns; i++) {
+        int x = i * width / doubledResolution;
+        float u = i * rescale;
+        
+        for (int j = range.firstRow; j <= range.firstRow + range.rows; j++) {
+            int y = j * height / doubledResolution;
             
-            ofVec2f texCoord1(tex_x0, tex_y0);
-            ofVec2f texCoord2(tex_x0, tex_y1);
+            *vertex++ = glm::vec3(x, y, 0);
+            *texCoord++ = glm::vec2(u, j * rescale);
+        }
+    }
+    
+    addLineIndices(key, range.columns, pointsPerLine, target);
+}
+
+void MeshGenerator::addLineIndices(const MeshKey& key, int lines, int pointsPerLine, ofMesh& target) {
+    std::vector<ofIndexType>& indices = target.getIndices();
+    
+    if (key.primitiveRestart) {
+        // One strip per line, separated by the restart index
+        indices.resize((size_t)lines * pointsPerLine + lines - 1);
+        ofIndexType* index = indices.data();
+        
+        for (int line = 0; line < lines; line++) {
+            ofIndexType first = line * pointsPerLine;
+            for (int point = 0; point < pointsPerLine; point++) {
+                *index++ = first + point;
+            }
             
-            // Add line segment
-            mesh.addVertex(vertex1);
-            mesh.addVertex(vertex2);
+            if (line < lines - 1) {
+                *index++ = getRestartIndex();
+            }
+        }
+        
+        target.setMode(OF_PRIMITIVE_LINE_STRIP);
+    } else {
+        // Without primitive restart draw segments, still indexing shared points
+        indices.resize((size_t)lines * (pointsPerLine - 1) * 2);
+        ofIndexType* index = indices.data();
+        
+        for (int line = 0; line < lines; line++) {
+            ofIndexType first = line * pointsPerLine;
+            for (int point = 0; point < pointsPerLine - 1; point++) {
+                *index++ = first + point;
+                *index++ = first + point + 1;
+            }
+        }
+        
+        target.setMode(OF_PRIMITIVE_LINES);
+    }
+}
+
+ofIndexType MeshGenerator::getRestartIndex() {
+    return std::numeric_limits<ofIndexType>::max();
+}
+
+size_t MeshGenerator::getNumVertices() const {
+    size_t numVertices = 0;
+    for (const MeshChunk& chunk : *currentMesh) {
+        numVertices += chunk.mesh.getNumVertices();
+    }
+    return numVertices;
+}
+
+size_t MeshGenerator::getNumIndices() const {
+    size_t numIndices = 0;
+    for (const MeshChunk& chunk : *currentMesh) {
+        numIndices += chunk.mesh.getNumIndices();
+    }
+    return numIndices;
+}
+
+size_t MeshGenerator::getNumDrawnVertices() const {
+    MeshRenderMode mode = getActiveRenderMode();
+    if (mode == MeshRenderMode::VertexBuffer) {
+        return getNumVertices();
+    }
+    
+    // Same counts drawProcedural() and drawInstanced() submit
+    size_t resolution = desiredKey.resolution;
+    if (desiredKey.type == MeshType::TriangleGrid) {
+        if (mode == MeshRenderMode::Procedural) {
+            return 2 * (resolution + 1) * resolution;
+        }
+        return 6 * resolution * resolution;
+    }
+    
+    size_t doubledResolution = resolution * 2;
+    if (mode == MeshRenderMode::Procedural) {
+        return (doubledResolution + 1) * doubledResolution;
+    }
+    return 2 * doubledResolution * doubledResolution;
+}
+
+int MeshGenerator::getNumChunks() const {
+    return currentMesh->size();
+}
+
+int MeshGenerator::getDrawnChunks() const {
+    return drawnChunks;
+}
+
+void MeshGenerator::setDisplacementBounds(const DisplacementBounds& bounds) {
+    displacementBounds = bounds;
+}
+
+void MeshGenerator::draw(ofShader& shader, bool wireframe) {
+    MeshRenderMode mode = getActiveRenderMode();
+    
+    if (isProceduralSupported()) {
+        shader.setUniform1i("procedural_grid", mode == MeshRenderMode::Procedural);
+        shader.setUniform1i("instanced_grid", mode == MeshRenderMode::Instanced);
+    }
+    
+    if (mode == MeshRenderMode::Procedural) {
+        drawProcedural(shader, wireframe);
+        return;
+    }
+    
+    if (mode == MeshRenderMode::Instanced) {
+        drawInstanced(shader, wireframe);
+        return;
+    }
+    
+#ifndef TARGET_OPENGLES
+    // Line strips are separated by the restart index
+    bool restart = currentKey.primitiveRestart && currentKey.type != MeshType::TriangleGrid;
+    if (restart) {
+        glEnable(GL_PRIMITIVE_RESTART);
+        glPrimitiveRestartIndex(getRestartIndex());
+    }
+#endif
+    
+    // Same transform the shader applies, used to skip chunks that can't reach the screen
+    glm::mat4 modelViewProjection = ofGetCurrentMatrix(OF_MATRIX_PROJECTION) * ofGetCurrentMatrix(OF_MATRIX_MODELVIEW);
+    bool cull = currentMesh->size() > 1;
+    
+    drawnChunks = 0;
+    for (MeshChunk& chunk : *currentMesh) {
+        if (cull && !isChunkVisible(chunk.bounds, modelViewProjection)) {
+            continue;
+        }
+        
+        if (wireframe) {
+            chunk.mesh.drawWireframe();
+        } else {
+            chunk.mesh.draw();
+        }
+        drawnChunks++;
+    }
+    
+#ifndef TARGET_OPENGLES
+    if (restart) {
+        glDisable(GL_PRIMITIVE_RESTART);
+    }
+#endif
+}
+
+bool MeshGenerator::isChunkVisible(const ofRectangle& bounds, const glm::mat4& modelViewProjection) const {
+    const DisplacementBounds& displacement = displacementBounds;
+    const glm::vec4 corners[] = {
+        glm::vec4(bounds.getLeft(), bounds.getTop(), 0, 1),
+        glm::vec4(bounds.getRight(), bounds.getTop(), 0, 1),
+        glm::vec4(bounds.getRight(), bounds.getBottom(), 0, 1),
+        glm::vec4(bounds.getLeft(), bounds.getBottom(), 0, 1)
+    };
+    const float scales[] = {displacement.minScale, displacement.maxScale};
+    
+    float minX = std::numeric_limits<float>::max();
+    float minY = std::numeric_limits<float>::max();
+    float maxX = -std::numeric_limits<float>::max();
+    float maxY = -std::numeric_limits<float>::max();
+    
+    // The shader scales around xy_offset and shifts in clip space before the
+    // perspective divide, the extremes are reached at the corners
+    for (const glm::vec4& corner : corners) {
+        glm::vec4 clip = modelViewProjection * corner;
+        if (clip.w <= 0.0001f) {
+            return true;
+        }
+        
+        for (float scale : scales) {
+            float x = (clip.x + displacement.offsetX) * scale - displacement.offsetX;
+            float y = (clip.y + displacement.offsetY) * scale - displacement.offsetY;
             
-            mesh.addTexCoord(texCoord1);
-            mesh.addTexCoord(texCoord2);
+            minX = std::min(minX, (x - displacement.shiftX) / clip.w);
+            maxX = std::max(maxX, (x + displacement.shiftX) / clip.w);
+            minY = std::min(minY, (y - displacement.shiftY) / clip.w);
+            maxY = std::max(maxY, (y + displacement.shiftY) / clip.w);
         }
     }
     
-    mesh.setMode(OF_PRIMITIVE_LINES);
-    vboMesh = mesh;
+    return maxX >= -1.0f && minX <= 1.0f && maxY >= -1.0f && minY <= 1.0f;
+}
+
+bool MeshGenerator::isProceduralSupported() const {
+#ifdef TARGET_OPENGLES
+    // ES2 has no gl_VertexID or instanced draws
+    return false;
+#else
+    return ofIsGLProgrammableRenderer();
+#endif
+}
+
+bool MeshGenerator::isPrimitiveRestartSupported() const {
+#ifdef TARGET_OPENGLES
+    // ES2 has no primitive restart
+    return false;
+#else
+    // Core since GL 3.1, so only on the programmable renderer
+    return ofIsGLProgrammableRenderer();
+#endif
 }
 
-ofVboMesh& MeshGenerator::getMesh() {
-    return vboMesh;
+MeshRenderMode MeshGenerator::getActiveRenderMode() const {
+    MeshRenderMode mode = paramManager->getMeshRenderMode();
+    if (mode != MeshRenderMode::VertexBuffer && !isProceduralSupported()) {
+        return MeshRenderMode::VertexBuffer;
+    }
+    return mode;
+}
+
+void MeshGenerator::drawProcedural(ofShader& shader, bool wireframe) {
+#ifndef TARGET_OPENGLES
+    // Core profile needs a vertex array bound even without attributes
+    if (proceduralVao == 0) {
+        glGenVertexArrays(1, &proceduralVao);
+    }
+    
+    int resolution = desiredKey.resolution;
+    
+    shader.setUniform1i("grid_type", static_cast<int>(desiredKey.type));
+    
+    glBindVertexArray(proceduralVao);
+    
+    if (desiredKey.type == MeshType::TriangleGrid) {
+        // One triangle strip per row: gl_InstanceID is the row,
+        // gl_VertexID alternates between the bottom and top grid points
+        shader.setUniform1i("grid_resolution", resolution);
+        
+        if (wireframe) {
+            glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        }
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 2 * (resolution + 1), resolution);
+        if (wireframe) {
+            glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        }
+    } else {
+        // One line strip per row (or column) at doubled resolution
+        int doubledResolution = resolution * 2;
+        shader.setUniform1i("grid_resolution", doubledResolution);
+        glDrawArraysInstanced(GL_LINE_STRIP, 0, doubledResolution + 1, doubledResolution);
+    }
+    
+    glBindVertexArray(0);
+#endif
+}
+
+void MeshGenerator::drawInstanced(ofShader& shader, bool wireframe) {
+    if (instanceQuad.getNumVertices() == 0) {
+        setupInstanceMeshes();
+    }
+    
+    int resolution = desiredKey.resolution;
+    ofPolyRenderMode renderMode = wireframe ? OF_MESH_WIREFRAME : OF_MESH_FILL;
+    
+    shader.setUniform1i("grid_type", static_cast<int>(desiredKey.type));
+    
+    // gl_InstanceID picks the cell, the shader offsets the unit cell into place
+    if (desiredKey.type == MeshType::TriangleGrid) {
+        shader.setUniform1i("grid_resolution", resolution);
+        shader.setUniform1i("grid_skip_cells", desiredKey.performanceMode);
+        instanceQuad.drawInstanced(renderMode, resolution * resolution);
+    } else {
+        int doubledResolution = resolution * 2;
+        shader.setUniform1i("grid_resolution", doubledResolution);
+        shader.setUniform1i("grid_skip_cells", 0);
+        
+        ofVboMesh& segment = desiredKey.type == MeshType::HorizontalLines
+            ? instanceHorizontalSegment : instanceVerticalSegment;
+        segment.drawInstanced(renderMode, doubledResolution * doubledResolution);
+    }
+}
+
+void MeshGenerator::setupInstanceMeshes() {
+    // Two triangles of a unit cell, z marks the second triangle so the shader
+    // can collapse it in cells that performance mode thins out
+    instanceQuad.clear();
+    instanceQuad.addVertex(glm::vec3(0, 0, 0));
+    instanceQuad.addVertex(glm::vec3(1, 0, 0));
+    instanceQuad.addVertex(glm::vec3(1, 1, 0));
+    instanceQuad.addVertex(glm::vec3(1, 1, 1));
+    instanceQuad.addVertex(glm::vec3(0, 1, 1));
+    instanceQuad.addVertex(glm::vec3(0, 0, 1));
+    instanceQuad.setMode(OF_PRIMITIVE_TRIANGLES);
+    
+    instanceHorizontalSegment.clear();
+    instanceHorizontalSegment.addVertex(glm::vec3(0, 0, 0));
+    instanceHorizontalSegment.addVertex(glm::vec3(1, 0, 0));
+    instanceHorizontalSegment.setMode(OF_PRIMITIVE_LINES);
+    
+    instanceVerticalSegment.clear();
+    instanceVerticalSegment.addVertex(glm::vec3(0, 0, 0));
+    instanceVerticalSegment.addVertex(glm::vec3(0, 1, 0));
+    instanceVerticalSegment.setMode(OF_PRIMITIVE_LINES);
 }
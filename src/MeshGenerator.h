@@ -2,45 +2,195 @@
 
 #include "ofMain.h"
 #include "ParameterManager.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 class MeshGenerator {
 public:
     MeshGenerator(ParameterManager* paramManager);
+    ~MeshGenerator();
     
     // Core methods
     void setup(int width, int height);
+    
+    // Rebuilds when the parameter manager's mesh revision changed
     void update();
     
-    // Mesh generation methods
-    void generateTriangleMesh(int resolution);
-    void generateHorizontalLineMesh(int resolution);
-    void generateVerticalLineMesh(int resolution);
+    // Largest change the displacement shader can make to a clip space
+    // position, used to skip chunks that can't reach the screen
+    struct DisplacementBounds {
+        float offsetX = 0.0f;  // xy_offset the z scaling is centred on
+        float offsetY = 0.0f;
+        float minScale = 1.0f; // Range of the z oscillator scaling
+        float maxScale = 1.0f;
+        float shiftX = 0.0f;   // Largest x and y displacement
+        float shiftY = 0.0f;
+    };
+    
+    // Mesh statistics, of the uploaded vertex buffer mesh
+    size_t getNumVertices() const;
+    size_t getNumIndices() const;
+    
+    // Vertices one draw sends through the vertex shader in the active render
+    // mode; procedural and instanced draws don't use the uploaded mesh
+    size_t getNumDrawnVertices() const;
+    int getNumChunks() const;
+    int getDrawnChunks() const;
+    
+    // Draws the current mesh with the displacement shader bound, chunks
+    // outside the displaced view are skipped
+    void draw(ofShader& shader, bool wireframe);
+    void setDisplacementBounds(const DisplacementBounds& bounds);
     
-    // Mesh access
-    ofVboMesh& getMesh();
+    // Procedural and instanced rendering build the grid in the GL3 vertex shader
+    bool isProceduralSupported() const;
     
-    // Updates mesh based on current parameter settings
+    // Render mode actually used, vertex buffers where the others aren't supported
+    MeshRenderMode getActiveRenderMode() const;
+    
+    // Line meshes use strips with primitive restart where available
+    bool isPrimitiveRestartSupported() const;
+    
+    // Updates mesh based on current parameter settings. Meshes that aren't
+    // cached are built on a background thread, the previous mesh keeps
+    // drawing until the new one is ready.
     void updateMeshFromParameters();
     
+    // Upper bound from the adaptive resolution controller, 0 for none
+    void setResolutionLimit(int limit);
+    int getResolution() const;
+    
+    // Mesh cache statistics
+    int getCacheSize() const;
+    size_t getCacheBytes() const;
+    int getCacheHits() const;
+    int getCacheMisses() const;
+    
+    // Meshes built over the last second
+    int getRebuildsPerSecond() const;
+    
+    // Grid cells per chunk side, (254 + 1)^2 vertices fit 16-bit indices
+    static constexpr int CHUNK_CELLS = 254;
+    
+    // Block of the grid drawn as one VBO, with its canvas bounds for culling
+    struct MeshChunk {
+        ofVboMesh mesh;
+        ofRectangle bounds;
+    };
+    typedef std::vector<MeshChunk> ChunkedMesh;
+    
+    // Identifies a generated mesh, used as the cache key
+    struct MeshKey {
+        MeshType type;
+        int resolution;
+        int width;
+        int height;
+        bool performanceMode;  // Performance mode drops triangles
+        bool primitiveRestart; // Lines are built as strips with restart indices
+        
+        bool operator==(const MeshKey& other) const {
+            return type == other.type && resolution == other.resolution &&
+                   width == other.width && height == other.height &&
+                   performanceMode == other.performanceMode &&
+                   primitiveRestart == other.primitiveRestart;
+        }
+    };
+    
+    // Builds a mesh without touching GL (thread safe, only touches the
+    // target mesh); public so the test executable can check and time it
+    static void generateMesh(const MeshKey& key, ChunkedMesh& target);
+    
 private:
+    // Cells of the full grid covered by a chunk
+    struct ChunkRange {
+        int firstColumn;
+        int firstRow;
+        int columns;
+        int rows;
+    };
+    
+    // Uploaded mesh kept around for fast switching
+    struct CachedMesh {
+        MeshKey key;
+        std::shared_ptr<ChunkedMesh> mesh;
+        size_t bytes;          // Approximate VBO size
+    };
+    
     // Canvas dimensions
     int width;
     int height;
     
-    // Mesh data
-    ofMesh mesh;
-    ofVboMesh vboMesh;
+    int resolutionLimit = 0;
+    
+    // Mesh being drawn and the settings it was built for
+    std::shared_ptr<ChunkedMesh> currentMesh;
+    MeshKey currentKey;
+    MeshKey desiredKey;
+    
+    // LRU mesh cache, most recently used first
+    std::list<CachedMesh> meshCache;
+    size_t cacheBytes;
+    int cacheHits;
+    int cacheMisses;
+    
+    // Chunk culling state
+    DisplacementBounds displacementBounds;
+    int drawnChunks = 0;
+    
+    // Empty vertex array for attribute-less procedural draws
+    GLuint proceduralVao = 0;
+    
+    // Unit cells for instanced draws, their size doesn't depend on the resolution
+    ofVboMesh instanceQuad;
+    ofVboMesh instanceHorizontalSegment;
+    ofVboMesh instanceVerticalSegment;
+    
+    // Background generation (GL thread side)
+    bool generationInFlight = false;
+    MeshKey inFlightKey;
+    
+    // Background generation (shared with the generator thread)
+    std::thread generatorThread;
+    std::mutex generatorMutex;
+    std::condition_variable generatorCondition;
+    bool stopGenerator = false;
+    bool hasPendingRequest = false;
+    MeshKey pendingKey;
+    bool hasGeneratedMesh = false;
+    MeshKey generatedKey;
+    std::shared_ptr<ChunkedMesh> generatedMesh;
     
     // Reference to parameter manager
     ParameterManager* paramManager;
     
+    // Mesh generation (thread safe, only touch the target mesh)
+    static void generateTriangleChunk(const MeshKey& key, const ChunkRange& range, ofMesh& target);
+    static void generateHorizontalLineChunk(const MeshKey& key, const ChunkRange& range, ofMesh& target);
+    static void generateVerticalLineChunk(const MeshKey& key, const ChunkRange& range, ofMesh& target);
+    static size_t countEven(int first, int count);
+    static void addLineIndices(const MeshKey& key, int lines, int pointsPerLine, ofMesh& target);
+    static ofIndexType getRestartIndex();
+    
     // Helper methods
-    void clearMesh();
-    void setupTriangleMesh(int resolution);
-    void setupHorizontalLineMesh(int resolution);
-    void setupVerticalLineMesh(int resolution);
-    
-    bool needsUpdate;
-    int lastScale;
-    MeshType lastMeshType;
+    MeshKey getKeyFromParameters() const;
+    void requestMesh(const MeshKey& key);
+    void applyGeneratedMesh();
+    void generatorThreadFunction();
+    void drawProcedural(ofShader& shader, bool wireframe);
+    void drawInstanced(ofShader& shader, bool wireframe);
+    void setupInstanceMeshes();
+    void addToCache(const MeshKey& key, std::shared_ptr<ChunkedMesh> mesh);
+    void evictCachedMeshes();
+    size_t getMeshBytes(const ChunkedMesh& source) const;
+    bool isChunkVisible(const ofRectangle& bounds, const glm::mat4& modelViewProjection) const;
+    
+    // Revision and resolution limit the current request was made for
+    unsigned int lastRevision = 0;
+    int lastResolutionLimit = 0;
+    
+    // Rebuild rate over one second windows
+    int rebuildCount = 0;
+    int rebuildsPerSecond = 0;
+    float rebuildWindowStart = 0.0f;
 };
@@ -0,0 +1,712 @@
+#include "NoiseGenerator.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define NOISE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if NOISE_SSE2 && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NOISE_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Ken Perlin's permutation
+const int permutation[256] = {
+    151,160,137,91,90,15,131,13,201,95,96,53,194,233,7,225,140,36,103,30,69,142,
+    8,99,37,240,21,10,23,190,6,148,247,120,234,75,0,26,197,62,94,252,219,203,117,
+    35,11,32,57,177,33,88,237,149,56,87,174,20,125,136,171,168,68,175,74,165,71,
+    134,139,48,27,166,77,146,158,231,83,111,229,122,60,211,133,230,220,105,92,41,
+    55,46,245,40,244,102,143,54,65,25,63,161,1,216,80,73,209,76,132,187,208,89,
+    18,169,200,196,135,130,116,188,159,86,164,100,109,198,173,186,3,64,52,217,226,
+    250,124,123,5,202,38,147,118,126,255,82,85,212,207,206,59,227,47,16,58,17,182,
+    189,28,42,223,183,170,213,119,248,152,2,44,154,163,70,221,153,101,155,167,43,
+    172,9,129,22,39,253,19,98,108,110,79,113,224,232,178,185,112,104,218,246,97,
+    228,251,34,242,193,238,210,144,12,191,179,162,241,81,51,145,235,249,14,239,
+    107,49,192,214,31,181,199,106,157,184,84,204,176,115,121,50,45,127,4,150,254,
+    138,236,205,93,222,114,67,29,24,72,243,141,128,195,78,66,215,61,156,180
+};
+
+// The permutation repeated twice so corner lookups never need wrapping
+struct PermTable {
+    int values[512];
+    PermTable() {
+        for (int i = 0; i < 512; i++) {
+            values[i] = permutation[i & 255];
+        }
+    }
+};
+
+const PermTable perm;
+
+// Skewing factors for 3D, written exactly as ofNoise has them
+const float F3 = 0.333333333f;
+const float G3 = 0.166666667f;
+
+inline int fastFloor(float x) {
+    return x > 0 ? (int)x : (int)x - 1;
+}
+
+inline float grad3(int hash, float x, float y, float z) {
+    int h = hash & 15;
+    float u = h < 8 ? x : y;
+    float v = h < 4 ? y : h == 12 || h == 14 ? x : z;
+    return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+}
+
+// Scalar kernel; the operation order follows ofNoise so results are identical
+float simplexNoise(float x, float y, float z) {
+    float s = (x + y + z) * F3;
+    int i = fastFloor(x + s);
+    int j = fastFloor(y + s);
+    int k = fastFloor(z + s);
+
+    float t = (float)(i + j + k) * G3;
+    float x0 = x - (i - t);
+    float y0 = y - (j - t);
+    float z0 = z - (k - t);
+
+    // Pick the simplex the point lies in
+    int i1, j1, k1, i2, j2, k2;
+    if (x0 >= y0) {
+        if (y0 >= z0)      { i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 1; k2 = 0; }
+        else if (x0 >= z0) { i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 0; k2 = 1; }
+        else               { i1 = 0; j1 = 0; k1 = 1; i2 = 1; j2 = 0; k2 = 1; }
+    } else {
+        if (y0 < z0)       { i1 = 0; j1 = 0; k1 = 1; i2 = 0; j2 = 1; k2 = 1; }
+        else if (x0 < z0)  { i1 = 0; j1 = 1; k1 = 0; i2 = 0; j2 = 1; k2 = 1; }
+        else               { i1 = 0; j1 = 1; k1 = 0; i2 = 1; j2 = 1; k2 = 0; }
+    }
+
+    float x1 = x0 - i1 + G3;
+    float y1 = y0 - j1 + G3;
+    float z1 = z0 - k1 + G3;
+    float x2 = x0 - i2 + 2.0f * G3;
+    float y2 = y0 - j2 + 2.0f * G3;
+    float z2 = z0 - k2 + 2.0f * G3;
+    float x3 = x0 - 1.0f + 3.0f * G3;
+    float y3 = y0 - 1.0f + 3.0f * G3;
+    float z3 = z0 - 1.0f + 3.0f * G3;
+
+    // Masking matches ofNoise for the non-negative coordinates we feed it,
+    // and stays inside the table for negative ones
+    int ii = i & 255;
+    int jj = j & 255;
+    int kk = k & 255;
+    const int* p = perm.values;
+
+    float n0 = 0.0f, n1 = 0.0f, n2 = 0.0f, n3 = 0.0f;
+
+    float t0 = 0.6f - x0 * x0 - y0 * y0 - z0 * z0;
+    if (t0 >= 0.0f) {
+        t0 *= t0;
+        n0 = t0 * t0 * grad3(p[ii + p[jj + p[kk]]], x0, y0, z0);
+    }
+    float t1 = 0.6f - x1 * x1 - y1 * y1 - z1 * z1;
+    if (t1 >= 0.0f) {
+        t1 *= t1;
+        n1 = t1 * t1 * grad3(p[ii + i1 + p[jj + j1 + p[kk + k1]]], x1, y1, z1);
+    }
+    float t2 = 0.6f - x2 * x2 - y2 * y2 - z2 * z2;
+    if (t2 >= 0.0f) {
+        t2 *= t2;
+        n2 = t2 * t2 * grad3(p[ii + i2 + p[jj + j2 + p[kk + k2]]], x2, y2, z2);
+    }
+    float t3 = 0.6f - x3 * x3 - y3 * y3 - z3 * z3;
+    if (t3 >= 0.0f) {
+        t3 *= t3;
+        n3 = t3 * t3 * grad3(p[ii + 1 + p[jj + 1 + p[kk + 1]]], x3, y3, z3);
+    }
+
+    return (32.0f * (n0 + n1 + n2 + n3)) * 0.5f + 0.5f;
+}
+
+// Improved Perlin noise spreads less than ofNoise's simplex noise: mapped
+// to [0, 1] its standard deviation is about 0.13 against 0.21. Stretching it
+// by 1.6 matches ofNoise, and the clamp flattens well under 1% of samples
+const float TILEABLE_CONTRAST = 1.6f;
+
+inline float fade(float t) {
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+inline float lerp(float t, float a, float b) {
+    return a + t * (b - a);
+}
+
+// Row kernels write out[i] = ofNoise((first + i) * step, y, z)
+void noiseRowScalar(float* out, int first, int begin, int count, float step, float y, float z) {
+    for (int i = begin; i < count; i++) {
+        out[i] = simplexNoise((first + i) * step, y, z);
+    }
+}
+
+#if NOISE_SSE2
+
+// The simplex tables above as lane masks (all bits set = 1):
+// a = x0 >= y0, b = y0 >= z0, c = x0 >= z0
+//   i1 = a & (b | c)     i2 = a | (b & c)
+//   j1 = !a & b          j2 = !a | b
+//   k1 = !b & !(a & c)   k2 = !b | (!a & !c)
+
+inline __m128 grad3SSE2(__m128i hash, __m128 x, __m128 y, __m128 z) {
+    __m128i h = _mm_and_si128(hash, _mm_set1_epi32(15));
+    __m128 hLess8 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(8)));
+    __m128 hLess4 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+    __m128 hUsesX = _mm_castsi128_ps(_mm_or_si128(_mm_cmpeq_epi32(h, _mm_set1_epi32(12)),
+                                                  _mm_cmpeq_epi32(h, _mm_set1_epi32(14))));
+    __m128 u = _mm_or_ps(_mm_and_ps(hLess8, x), _mm_andnot_ps(hLess8, y));
+    __m128 v = _mm_or_ps(_mm_and_ps(hUsesX, x), _mm_andnot_ps(hUsesX, z));
+    v = _mm_or_ps(_mm_and_ps(hLess4, y), _mm_andnot_ps(hLess4, v));
+    // Flip signs straight from hash bits 0 and 1
+    __m128 uSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(1)), 31));
+    __m128 vSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(2)), 30));
+    return _mm_add_ps(_mm_xor_ps(u, uSign), _mm_xor_ps(v, vSign));
+}
+
+inline __m128 cornerSSE2(__m128 x, __m128 y, __m128 z, __m128i hash) {
+    __m128 t = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_set1_ps(0.6f), _mm_mul_ps(x, x)),
+                                     _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+    __m128 t2 = _mm_mul_ps(t, t);
+    __m128 n = _mm_mul_ps(_mm_mul_ps(t2, t2), grad3SSE2(hash, x, y, z));
+    return _mm_andnot_ps(_mm_cmplt_ps(t, _mm_setzero_ps()), n);
+}
+
+// fastFloor: truncate, then subtract one unless positive
+inline __m128i fastFloorSSE2(__m128 v) {
+    __m128i notPositive = _mm_castps_si128(_mm_cmple_ps(v, _mm_setzero_ps()));
+    return _mm_add_epi32(_mm_cvttps_epi32(v), notPositive);
+}
+
+// No gather before AVX2, so the hashes are looked up per lane
+inline __m128i hashSSE2(__m128i ii, __m128i jj, __m128i kk) {
+    alignas(16) int i[4], j[4], k[4], h[4];
+    _mm_store_si128((__m128i*)i, ii);
+    _mm_store_si128((__m128i*)j, jj);
+    _mm_store_si128((__m128i*)k, kk);
+    const int* p = perm.values;
+    for (int lane = 0; lane < 4; lane++) {
+        h[lane] = p[i[lane] + p[j[lane] + p[k[lane]]]];
+    }
+    return _mm_load_si128((const __m128i*)h);
+}
+
+int noiseRowSSE2(float* out, int first, int count, float step, float y, float z) {
+    const __m128 vStep = _mm_set1_ps(step);
+    const __m128 vy = _mm_set1_ps(y);
+    const __m128 vz = _mm_set1_ps(z);
+    const __m128 f3 = _mm_set1_ps(F3);
+    const __m128 g3 = _mm_set1_ps(G3);
+    const __m128 g3x2 = _mm_set1_ps(2.0f * G3);
+    const __m128 g3x3 = _mm_set1_ps(3.0f * G3);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128i ones = _mm_set1_epi32(-1);
+    const __m128i byteMask = _mm_set1_epi32(255);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(first + i), _mm_setr_epi32(0, 1, 2, 3))), vStep);
+
+        __m128 s = _mm_mul_ps(_mm_add_ps(_mm_add_ps(x, vy), vz), f3);
+        __m128i ci = fastFloorSSE2(_mm_add_ps(x, s));
+        __m128i cj = fastFloorSSE2(_mm_add_ps(vy, s));
+        __m128i ck = fastFloorSSE2(_mm_add_ps(vz, s));
+
+        __m128 t = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(_mm_add_epi32(ci, cj), ck)), g3);
+        __m128 x0 = _mm_sub_ps(x, _mm_sub_ps(_mm_cvtepi32_ps(ci), t));
+        __m128 y0 = _mm_sub_ps(vy, _mm_sub_ps(_mm_cvtepi32_ps(cj), t));
+        __m128 z0 = _mm_sub_ps(vz, _mm_sub_ps(_mm_cvtepi32_ps(ck), t));
+
+        __m128i a = _mm_castps_si128(_mm_cmpge_ps(x0, y0));
+        __m128i b = _mm_castps_si128(_mm_cmpge_ps(y0, z0));
+        __m128i c = _mm_castps_si128(_mm_cmpge_ps(x0, z0));
+        __m128i i1 = _mm_and_si128(a, _mm_or_si128(b, c));
+        __m128i j1 = _mm_andnot_si128(a, b);
+        __m128i k1 = _mm_andnot_si128(b, _mm_andnot_si128(_mm_and_si128(a, c), ones));
+        __m128i i2 = _mm_or_si128(a, _mm_and_si128(b, c));
+        __m128i j2 = _mm_or_si128(_mm_andnot_si128(a, ones), b);
+        __m128i k2 = _mm_or_si128(_mm_andnot_si128(b, ones), _mm_andnot_si128(_mm_or_si128(a, c), ones));
+
+        __m128 x1 = _mm_add_ps(_mm_sub_ps(x0, _mm_and_ps(_mm_castsi128_ps(i1), one)), g3);
+        __m128 y1 = _mm_add_ps(_mm_sub_ps(y0, _mm_and_ps(_mm_castsi128_ps(j1), one)), g3);
+        __m128 z1 = _mm_add_ps(_mm_sub_ps(z0, _mm_and_ps(_mm_castsi128_ps(k1), one)), g3);
+        __m128 x2 = _mm_add_ps(_mm_sub_ps(x0, _mm_and_ps(_mm_castsi128_ps(i2), one)), g3x2);
+        __m128 y2 = _mm_add_ps(_mm_sub_ps(y0, _mm_and_ps(_mm_castsi128_ps(j2), one)), g3x2);
+        __m128 z2 = _mm_add_ps(_mm_sub_ps(z0, _mm_and_ps(_mm_castsi128_ps(k2), one)), g3x2);
+        __m128 x3 = _mm_add_ps(_mm_sub_ps(x0, one), g3x3);
+        __m128 y3 = _mm_add_ps(_mm_sub_ps(y0, one), g3x3);
+        __m128 z3 = _mm_add_ps(_mm_sub_ps(z0, one), g3x3);
+
+        __m128i ii = _mm_and_si128(ci, byteMask);
+        __m128i jj = _mm_and_si128(cj, byteMask);
+        __m128i kk = _mm_and_si128(ck, byteMask);
+        // Masks are -1 where set, so subtracting them adds the offset
+        __m128i h0 = hashSSE2(ii, jj, kk);
+        __m128i h1 = hashSSE2(_mm_sub_epi32(ii, i1), _mm_sub_epi32(jj, j1), _mm_sub_epi32(kk, k1));
+        __m128i h2 = hashSSE2(_mm_sub_epi32(ii, i2), _mm_sub_epi32(jj, j2), _mm_sub_epi32(kk, k2));
+        __m128i h3 = hashSSE2(_mm_sub_epi32(ii, ones), _mm_sub_epi32(jj, ones), _mm_sub_epi32(kk, ones));
+
+        __m128 n = _mm_add_ps(_mm_add_ps(_mm_add_ps(cornerSSE2(x0, y0, z0, h0),
+                                                    cornerSSE2(x1, y1, z1, h1)),
+                                         cornerSSE2(x2, y2, z2, h2)),
+                              cornerSSE2(x3, y3, z3, h3));
+        n = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(n, _mm_set1_ps(32.0f)), _mm_set1_ps(0.5f)), _mm_set1_ps(0.5f));
+        _mm_storeu_ps(out + i, n);
+    }
+    return i;
+}
+
+#endif
+
+#if NOISE_AVX2
+
+// Same kernel as SSE2, 8 lanes wide with gathered hash lookups
+
+__attribute__((target("avx2")))
+inline __m256 grad3AVX2(__m256i hash, __m256 x, __m256 y, __m256 z) {
+    __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(15));
+    __m256 hLess8 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(8), h));
+    __m256 hLess4 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(4), h));
+    __m256 hUsesX = _mm256_castsi256_ps(_mm256_or_si256(_mm256_cmpeq_epi32(h, _mm256_set1_epi32(12)),
+                                                        _mm256_cmpeq_epi32(h, _mm256_set1_epi32(14))));
+    __m256 u = _mm256_blendv_ps(y, x, hLess8);
+    __m256 v = _mm256_blendv_ps(_mm256_blendv_ps(z, x, hUsesX), y, hLess4);
+    __m256 uSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1)), 31));
+    __m256 vSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), 30));
+    return _mm256_add_ps(_mm256_xor_ps(u, uSign), _mm256_xor_ps(v, vSign));
+}
+
+__attribute__((target("avx2")))
+inline __m256 cornerAVX2(__m256 x, __m256 y, __m256 z, __m256i hash) {
+    __m256 t = _mm256_sub_ps(_mm256_sub_ps(_mm256_sub_ps(_mm256_set1_ps(0.6f), _mm256_mul_ps(x, x)),
+                                           _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+    __m256 t2 = _mm256_mul_ps(t, t);
+    __m256 n = _mm256_mul_ps(_mm256_mul_ps(t2, t2), grad3AVX2(hash, x, y, z));
+    return _mm256_andnot_ps(_mm256_cmp_ps(t, _mm256_setzero_ps(), _CMP_LT_OQ), n);
+}
+
+__attribute__((target("avx2")))
+inline __m256i hashAVX2(__m256i ii, __m256i jj, __m256i kk) {
+    const int* p = perm.values;
+    __m256i h = _mm256_i32gather_epi32(p, kk, 4);
+    h = _mm256_i32gather_epi32(p, _mm256_add_epi32(jj, h), 4);
+    return _mm256_i32gather_epi32(p, _mm256_add_epi32(ii, h), 4);
+}
+
+__attribute__((target("avx2")))
+inline __m256i fastFloorAVX2(__m256 v) {
+    __m256i notPositive = _mm256_castps_si256(_mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_LE_OQ));
+    return _mm256_add_epi32(_mm256_cvttps_epi32(v), notPositive);
+}
+
+__attribute__((target("avx2")))
+int noiseRowAVX2(float* out, int first, int count, float step, float y, float z) {
+    const __m256 vStep = _mm256_set1_ps(step);
+    const __m256 vy = _mm256_set1_ps(y);
+    const __m256 vz = _mm256_set1_ps(z);
+    const __m256 g3 = _mm256_set1_ps(G3);
+    const __m256 g3x2 = _mm256_set1_ps(2.0f * G3);
+    const __m256 g3x3 = _mm256_set1_ps(3.0f * G3);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256i ones = _mm256_set1_epi32(-1);
+    const __m256i byteMask = _mm256_set1_epi32(255);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i index = _mm256_add_epi32(_mm256_set1_epi32(first + i), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        __m256 x = _mm256_mul_ps(_mm256_cvtepi32_ps(index), vStep);
+
+        __m256 s = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(x, vy), vz), _mm256_set1_ps(F3));
+        __m256i ci = fastFloorAVX2(_mm256_add_ps(x, s));
+        __m256i cj = fastFloorAVX2(_mm256_add_ps(vy, s));
+        __m256i ck = fastFloorAVX2(_mm256_add_ps(vz, s));
+
+        __m256 t = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_add_epi32(ci, cj), ck)), g3);
+        __m256 x0 = _mm256_sub_ps(x, _mm256_sub_ps(_mm256_cvtepi32_ps(ci), t));
+        __m256 y0 = _mm256_sub_ps(vy, _mm256_sub_ps(_mm256_cvtepi32_ps(cj), t));
+        __m256 z0 = _mm256_sub_ps(vz, _mm256_sub_ps(_mm256_cvtepi32_ps(ck), t));
+
+        __m256i a = _mm256_castps_si256(_mm256_cmp_ps(x0, y0, _CMP_GE_OQ));
+        __m256i b = _mm256_castps_si256(_mm256_cmp_ps(y0, z0, _CMP_GE_OQ));
+        __m256i c = _mm256_castps_si256(_mm256_cmp_ps(x0, z0, _CMP_GE_OQ));
+        __m256i i1 = _mm256_and_si256(a, _mm256_or_si256(b, c));
+        __m256i j1 = _mm256_andnot_si256(a, b);
+        __m256i k1 = _mm256_andnot_si256(b, _mm256_andnot_si256(_mm256_and_si256(a, c), ones));
+        __m256i i2 = _mm256_or_si256(a, _mm256_and_si256(b, c));
+        __m256i j2 = _mm256_or_si256(_mm256_andnot_si256(a, ones), b);
+        __m256i k2 = _mm256_or_si256(_mm256_andnot_si256(b, ones),
+                                     _mm256_andnot_si256(_mm256_or_si256(a, c), ones));
+
+        __m256 x1 = _mm256_add_ps(_mm256_sub_ps(x0, _mm256_and_ps(_mm256_castsi256_ps(i1), one)), g3);
+        __m256 y1 = _mm256_add_ps(_mm256_sub_ps(y0, _mm256_and_ps(_mm256_castsi256_ps(j1), one)), g3);
+        __m256 z1 = _mm256_add_ps(_mm256_sub_ps(z0, _mm256_and_ps(_mm256_castsi256_ps(k1), one)), g3);
+        __m256 x2 = _mm256_add_ps(_mm256_sub_ps(x0, _mm256_and_ps(_mm256_castsi256_ps(i2), one)), g3x2);
+        __m256 y2 = _mm256_add_ps(_mm256_sub_ps(y0, _mm256_and_ps(_mm256_castsi256_ps(j2), one)), g3x2);
+        __m256 z2 = _mm256_add_ps(_mm256_sub_ps(z0, _mm256_and_ps(_mm256_castsi256_ps(k2), one)), g3x2);
+        __m256 x3 = _mm256_add_ps(_mm256_sub_ps(x0, one), g3x3);
+        __m256 y3 = _mm256_add_ps(_mm256_sub_ps(y0, one), g3x3);
+        __m256 z3 = _mm256_add_ps(_mm256_sub_ps(z0, one), g3x3);
+
+        __m256i ii = _mm256_and_si256(ci, byteMask);
+        __m256i jj = _mm256_and_si256(cj, byteMask);
+        __m256i kk = _mm256_and_si256(ck, byteMask);
+        __m256i h0 = hashAVX2(ii, jj, kk);
+        __m256i h1 = hashAVX2(_mm256_sub_epi32(ii, i1), _mm256_sub_epi32(jj, j1), _mm256_sub_epi32(kk, k1));
+        __m256i h2 = hashAVX2(_mm256_sub_epi32(ii, i2), _mm256_sub_epi32(jj, j2), _mm256_sub_epi32(kk, k2));
+        __m256i h3 = hashAVX2(_mm256_sub_epi32(ii, ones), _mm256_sub_epi32(jj, ones), _mm256_sub_epi32(kk, ones));
+
+        __m256 n = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(cornerAVX2(x0, y0, z0, h0),
+                                                             cornerAVX2(x1, y1, z1, h1)),
+                                               cornerAVX2(x2, y2, z2, h2)),
+                                 cornerAVX2(x3, y3, z3, h3));
+        n = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(n, _mm256_set1_ps(32.0f)), _mm256_set1_ps(0.5f)),
+                          _mm256_set1_ps(0.5f));
+        _mm256_storeu_ps(out + i, n);
+    }
+    return i;
+}
+
+#endif
+
+// Vector kernels return how many values they wrote; the scalar one finishes the row
+typedef int (*RowKernel)(float* out, int first, int count, float step, float y, float z);
+
+struct KernelChoice {
+    RowKernel kernel;
+    const char* name;
+};
+
+KernelChoice chooseKernel() {
+#if NOISE_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        return {noiseRowAVX2, "AVX2"};
+    }
+#endif
+#if NOISE_SSE2
+    return {noiseRowSSE2, "SSE2"};
+#else
+    return {nullptr, "scalar"};
+#endif
+}
+
+const KernelChoice& getKernel() {
+    static const KernelChoice choice = chooseKernel();
+    return choice;
+}
+
+void noiseRow(float* out, int first, int count, float step, float y, float z) {
+    const KernelChoice& choice = getKernel();
+    int done = choice.kernel ? choice.kernel(out, first, count, step, y, z) : 0;
+    noiseRowScalar(out, first, done, count, step, y, z);
+}
+
+// Rows are done in spans so the float scratch stays on the stack
+const int SPAN = 256;
+
+// Fill rows [firstRow, lastRow) of a field with normalized fBm. Every
+// octave of a span is evaluated densely with the vector row kernel and
+// summed into one float row, which is converted to bytes once
+void fillFbmPixels(const NoiseGenerator::Field& field, int firstRow, int lastRow) {
+    int octaves = std::min(field.octaves, NoiseGenerator::MAX_OCTAVES);
+    float weights[NoiseGenerator::MAX_OCTAVES];
+    float steps[NoiseGenerator::MAX_OCTAVES];
+    float depths[NoiseGenerator::MAX_OCTAVES];
+    
+    float totalAmplitude = 0;
+    float amplitude = 1;
+    for (int octave = 0; octave < octaves; octave++) {
+        totalAmplitude += amplitude;
+        amplitude *= field.gain;
+    }
+    
+    float frequency = 1;
+    amplitude = 1;
+    for (int octave = 0; octave < octaves; octave++) {
+        weights[octave] = amplitude / totalAmplitude;
+        steps[octave] = field.step * frequency;
+        depths[octave] = field.z * frequency + octave * NoiseGenerator::FBM_OCTAVE_OFFSET;
+        frequency *= field.lacunarity;
+        amplitude *= field.gain;
+    }
+    
+    float values[SPAN];
+    float samples[SPAN];
+    
+    for (int y = firstRow; y < lastRow; y++) {
+        unsigned char* row = field.pixels + (size_t)y * field.width * field.pixelStride;
+        for (int x = 0; x < field.width; x += SPAN) {
+            int count = std::min(SPAN, field.width - x);
+            std::fill(values, values + count, 0.0f);
+            
+            for (int octave = 0; octave < octaves; octave++) {
+                noiseRow(samples, x, count, steps[octave], y * steps[octave], depths[octave]);
+                for (int i = 0; i < count; i++) {
+                    values[i] += weights[octave] * samples[i];
+                }
+            }
+            
+            unsigned char* out = row + (size_t)x * field.pixelStride;
+            for (int i = 0; i < count; i++) {
+                out[i * field.pixelStride] = 255 * values[i];
+            }
+        }
+    }
+}
+
+}
+
+//--------------------------------------------------------------
+NoiseGenerator::NoiseGenerator() {
+}
+
+//--------------------------------------------------------------
+NoiseGenerator::~NoiseGenerator() {
+    // Let queued bands finish so nobody writes into freed pixels
+    wait();
+    
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        stopWorkers = true;
+    }
+    workCondition.notify_all();
+    
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+//--------------------------------------------------------------
+void NoiseGenerator::setup(int numThreads) {
+    if (!workers.empty()) return;
+    
+    if (numThreads <= 0) {
+        int cores = (int)std::thread::hardware_concurrency();
+        numThreads = std::max(1, cores - 1);
+    }
+    
+    for (int i = 0; i < numThreads; i++) {
+        workers.emplace_back(&NoiseGenerator::workerThreadFunction, this);
+    }
+    
+    ofLogNotice("NoiseGenerator") << "Noise pool running " << numThreads << " workers with the "
+                                  << getKernelName() << " kernel";
+}
+
+//--------------------------------------------------------------
+void NoiseGenerator::start(std::initializer_list<Field> newFields) {
+    start(newFields.begin(), newFields.size());
+}
+
+//--------------------------------------------------------------
+void NoiseGenerator::start(const std::vector<Field>& newFields) {
+    start(newFields.data(), newFields.size());
+}
+
+//--------------------------------------------------------------
+void NoiseGenerator::start(const Field* newFields, size_t count) {
+    // Never reuse the job lists while bands are still being worked on
+    wait();
+    
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        fields.assign(newFields, newFields + count);
+        bands.clear();
+        for (int f = 0; f < (int)fields.size(); f++) {
+            for (int row = 0; row < fields[f].height; row += BAND_ROWS) {
+                bands.push_back({f, row, std::min(row + BAND_ROWS, fields[f].height)});
+            }
+        }
+        nextBand = 0;
+        finishedBands = 0;
+    }
+    workCondition.notify_all();
+}
+
+//--------------------------------------------------------------
+void NoiseGenerator::wait() {
+    // The caller would only sit idle, so it takes bands too
+    while (runNextBand()) {
+    }
+    
+    std::unique_lock<std::mutex> lock(poolMutex);
+    doneCondition.wait(lock, [this] {
+        return finishedBands == bands.size();
+    });
+}
+
+//--------------------------------------------------------------
+int NoiseGenerator::getNumThreads() const {
+    return (int)workers.size();
+}
+
+//--------------------------------------------------------------
+bool NoiseGenerator::runNextBand() {
+    Band band;
+    Field field;
+    
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (nextBand >= bands.size()) {
+            return false;
+        }
+        band = bands[nextBand++];
+        field = fields[band.field];
+    }
+    
+    fillPixels(field, band.firstRow, band.lastRow);
+    
+    bool allDone;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        allDone = ++finishedBands == bands.size();
+    }
+    if (allDone) {
+        doneCondition.notify_all();
+    }
+    return true;
+}
+
+//--------------------------------------------------------------
+void NoiseGenerator::workerThreadFunction() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(poolMutex);
+            workCondition.wait(lock, [this] {
+                return stopWorkers || nextBand < bands.size();
+            });
+            
+            if (stopWorkers) {
+                return;
+            }
+        }
+        
+        while (runNextBand()) {
+        }
+    }
+}
+
+//--------------------------------------------------------------
+float NoiseGenerator::noise(float x, float y, float z) {
+    return simplexNoise(x, y, z);
+}
+
+//--------------------------------------------------------------
+void NoiseGenerator::noiseRow(float* out, int count, float step, float y, float z) {
+    ::noiseRow(out, 0, count, step, y, z);
+}
+
+//--------------------------------------------------------------
+void NoiseGenerator::fillPixels(const Field& field, int firstRow, int lastRow) {
+    if (field.octaves > 1) {
+        fillFbmPixels(field, firstRow, lastRow);
+        return;
+    }
+    
+    float values[SPAN];
+
+    for (int y = firstRow; y < lastRow; y++) {
+        unsigned char* row = field.pixels + (size_t)y * field.width * field.pixelStride;
+        for (int x = 0; x < field.width; x += SPAN) {
+            int count = std::min(SPAN, field.width - x);
+            ::noiseRow(values, x, count, field.step, y * field.step, field.z);
+            unsigned char* out = row + (size_t)x * field.pixelStride;
+            for (int i = 0; i < count; i++) {
+                out[i * field.pixelStride] = 255 * values[i];
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------
+void NoiseGenerator::fillPixels(unsigned char* pixels, int width, int height, float step, float z) {
+    fillPixels({pixels, width, height, step, z}, 0, height);
+}
+
+//--------------------------------------------------------------
+NoiseGenerator::FieldKey NoiseGenerator::getKey(const Field& field) {
+    // 1/65536 of a lattice cell: across a 180 pixel row the step rounding
+    // moves the last sample by under 0.003 cells, far below one 8-bit step
+    const double QUANTUM = 65536.0;
+    
+    FieldKey key;
+    key.width = field.width;
+    key.height = field.height;
+    key.step = llround(field.step * QUANTUM);
+    key.z = llround(field.z * QUANTUM);
+    key.octaves = field.octaves;
+    key.lacunarity = llround(field.lacunarity * QUANTUM);
+    key.gain = llround(field.gain * QUANTUM);
+    return key;
+}
+
+//--------------------------------------------------------------
+bool NoiseGenerator::FieldKey::operator==(const FieldKey& other) const {
+    return width == other.width && height == other.height && step == other.step && z == other.z &&
+           octaves == other.octaves && lacunarity == other.lacunarity && gain == other.gain;
+}
+
+//--------------------------------------------------------------
+bool NoiseGenerator::FieldKey::operator!=(const FieldKey& other) const {
+    return !(*this == other);
+}
+
+//--------------------------------------------------------------
+const char* NoiseGenerator::getKernelName() {
+    return getKernel().name;
+}
+
+//--------------------------------------------------------------
+float NoiseGenerator::tileableNoise(float x, float y, float z, int period) {
+    // Improved Perlin noise with the lattice wrapped at `period` cells
+    int xi = fastFloor(x);
+    int yi = fastFloor(y);
+    int zi = fastFloor(z);
+    x -= xi;
+    y -= yi;
+    z -= zi;
+    
+    // Positive modulo so negative coordinates wrap the same way
+    int x0 = ((xi % period) + period) % period;
+    int y0 = ((yi % period) + period) % period;
+    int z0 = ((zi % period) + period) % period;
+    int x1 = (x0 + 1) % period;
+    int y1 = (y0 + 1) % period;
+    int z1 = (z0 + 1) % period;
+    
+    const int* p = perm.values;
+    int a0 = p[p[x0] + y0];
+    int a1 = p[p[x0] + y1];
+    int b0 = p[p[x1] + y0];
+    int b1 = p[p[x1] + y1];
+    
+    float u = fade(x);
+    float v = fade(y);
+    float w = fade(z);
+    
+    float n = lerp(w, lerp(v, lerp(u, grad3(p[a0 + z0], x, y, z),
+                                      grad3(p[b0 + z0], x - 1, y, z)),
+                              lerp(u, grad3(p[a1 + z0], x, y - 1, z),
+                                      grad3(p[b1 + z0], x - 1, y - 1, z))),
+                      lerp(v, lerp(u, grad3(p[a0 + z1], x, y, z - 1),
+                                      grad3(p[b0 + z1], x - 1, y, z - 1)),
+                              lerp(u, grad3(p[a1 + z1], x, y - 1, z - 1),
+                                      grad3(p[b1 + z1], x - 1, y - 1, z - 1))));
+    return ofClamp(n * TILEABLE_CONTRAST * 0.5f + 0.5f, 0.0f, 1.0f);
+}
+
+//--------------------------------------------------------------
+void NoiseGenerator::bakeTileableVolume(unsigned char* voxels, int size, int period) {
+    float step = (float)period / size;
+    
+    for (int z = 0; z < size; z++) {
+        for (int y = 0; y < size; y++) {
+            unsigned char* row = voxels + ((size_t)z * size + y) * size;
+            for (int x = 0; x < size; x++) {
+                row[x] = 255 * tileableNoise(x * step, y * step, z * step, period);
+            }
+        }
+    }
+}
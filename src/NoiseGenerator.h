@@ -0,0 +1,128 @@
+#pragma once
+
+#include "ofMain.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// 3D simplex noise evaluated a row at a time, matching ofNoise(x, y, z).
+// On x86 a row is computed 4 (SSE2) or 8 (AVX2) pixels per step; other
+// targets such as ARM/NEON use the scalar kernel.
+//
+// Noise fields are filled by a small worker pool: each field is split into
+// row bands and the bands of all queued fields are shared out between the
+// workers, so the fill overlaps with whatever the caller does until wait().
+class NoiseGenerator {
+public:
+    // One 8-bit field: pixels = 255 * ofNoise(x * step, y * step, z). With a
+    // pixel stride above 1 it fills one channel of an interleaved image.
+    // More than one octave sums fractal Brownian motion instead: octave i is
+    // ofNoise at lacunarity^i times the coordinates, offset in z by
+    // i * FBM_OCTAVE_OFFSET and weighted by gain^i, normalized to [0, 1]
+    struct Field {
+        unsigned char* pixels;
+        int width;
+        int height;
+        float step;
+        float z;
+        int pixelStride = 1;
+        int octaves = 1;
+        float lacunarity = 2.0f;
+        float gain = 0.5f;
+    };
+    
+    // Quantized inputs of a field; fields with equal keys have the same pixels
+    struct FieldKey {
+        int width = 0;
+        int height = 0;
+        int64_t step = 0;
+        int64_t z = 0;
+        int octaves = 0;
+        int64_t lacunarity = 0;
+        int64_t gain = 0;
+        
+        bool operator==(const FieldKey& other) const;
+        bool operator!=(const FieldKey& other) const;
+    };
+    
+    // Octaves beyond this are ignored
+    static constexpr int MAX_OCTAVES = 8;
+    
+    // Phase offset between octaves so they don't all share a lattice origin
+    static constexpr float FBM_OCTAVE_OFFSET = 17.31f;
+    
+    // Accepted fBm settings. A gain in (0, 1] keeps the octave weights
+    // finite and falling off; a lacunarity of at most 4 keeps the top
+    // octave's coordinates far inside the int range the kernel floors to
+    static constexpr float MIN_FBM_GAIN = 0.01f;
+    static constexpr float MIN_FBM_LACUNARITY = 1.0f;
+    static constexpr float MAX_FBM_LACUNARITY = 4.0f;
+    
+    NoiseGenerator();
+    ~NoiseGenerator();
+    
+    // Start the workers; 0 picks one per core, leaving one for the GL thread
+    void setup(int numThreads = 0);
+    
+    // Queue fields and return straight away; the pixels must stay untouched
+    // until wait() returns. The job lists keep their capacity, so steady
+    // state updates don't allocate
+    void start(std::initializer_list<Field> fields);
+    void start(const std::vector<Field>& fields);
+    void start(const Field* fields, size_t count);
+    
+    // Help with the remaining bands, then block until every field is done
+    void wait();
+    
+    int getNumThreads() const;
+    
+    // Same value as ofNoise(x, y, z)
+    static float noise(float x, float y, float z);
+
+    // out[i] = ofNoise(i * step, y, z) for i in [0, count)
+    static void noiseRow(float* out, int count, float step, float y, float z);
+
+    // Fill rows [firstRow, lastRow) of a field
+    static void fillPixels(const Field& field, int firstRow, int lastRow);
+    static void fillPixels(unsigned char* pixels, int width, int height, float step, float z);
+    
+    // Cache key of a field's inputs, quantized finely enough that fields
+    // with equal keys differ by well under one 8-bit step
+    static FieldKey getKey(const Field& field);
+
+    // Kernel picked for this CPU ("AVX2", "SSE2" or "scalar")
+    static const char* getKernelName();
+
+    // Gradient noise in [0, 1] that repeats every `period` units on all axes
+    static float tileableNoise(float x, float y, float z, int period);
+    
+    // Bake size^3 voxels (x fastest, then y, then z) of tileableNoise with
+    // `period` lattice cells across the volume, so it wraps seamlessly
+    static void bakeTileableVolume(unsigned char* voxels, int size, int period);
+
+private:
+    // A band of rows within one queued field
+    struct Band {
+        int field;
+        int firstRow;
+        int lastRow;
+    };
+    
+    // Rows per band, small enough to balance three fields over a few cores
+    static constexpr int BAND_ROWS = 8;
+    
+    bool runNextBand();
+    void workerThreadFunction();
+    
+    std::vector<std::thread> workers;
+    std::mutex poolMutex;
+    std::condition_variable workCondition;
+    std::condition_variable doneCondition;
+    bool stopWorkers = false;
+    
+    // Current job, guarded by poolMutex
+    std::vector<Field> fields;
+    std::vector<Band> bands;
+    size_t nextBand = 0;
+    size_t finishedBands = 0;
+};
@@ -0,0 +1,131 @@
+#include "NoiseVolume.h"
+#include "NoiseGenerator.h"
+
+NoiseVolume::NoiseVolume()
+    : baked(false), bakeMicros(0), uploaded(false),
+      useVolumeTexture(false), volumeTexture(0), allocated(false) {
+}
+
+NoiseVolume::~NoiseVolume() {
+    if (bakeThread.joinable()) {
+        bakeThread.join();
+    }
+    
+#ifndef TARGET_OPENGLES
+    if (volumeTexture != 0) {
+        glDeleteTextures(1, &volumeTexture);
+    }
+#endif
+}
+
+void NoiseVolume::setup() {
+    if (bakeThread.joinable() || uploaded) return;
+    
+    // Baking takes long enough to drop frames, the upload is quick
+    bakeThread = std::thread([this] {
+        uint64_t start = ofGetElapsedTimeMicros();
+        voxels.resize((size_t)SIZE * SIZE * SIZE);
+        NoiseGenerator::bakeTileableVolume(voxels.data(), SIZE, PERIOD);
+        bakeMicros = ofGetElapsedTimeMicros() - start;
+        baked = true;
+    });
+}
+
+void NoiseVolume::update() {
+    if (uploaded || !baked) return;
+    bakeThread.join();
+    uploaded = true;
+    
+    // 3D textures on the GL3 renderer, an atlas of slices everywhere else
+#ifndef TARGET_OPENGLES
+    useVolumeTexture = ofIsGLProgrammableRenderer();
+#endif
+    
+    if (useVolumeTexture) {
+        uploadVolumeTexture(voxels);
+    } else {
+        uploadAtlasTexture(voxels);
+    }
+    voxels = std::vector<unsigned char>();
+    
+    if (allocated) {
+        ofLogNotice("NoiseVolume") << "Baked " << SIZE << "^3 noise volume in the background in "
+                                   << bakeMicros / 1000.0f << "ms, uploaded as "
+                                   << (useVolumeTexture ? "3D texture" : "slice atlas");
+    } else {
+        ofLogWarning("NoiseVolume") << "Noise volume unavailable, noise stays on the CPU";
+    }
+}
+
+bool NoiseVolume::isAllocated() const {
+    return allocated;
+}
+
+void NoiseVolume::bind(ofShader& shader, int textureLocation) {
+    if (!allocated) return;
+    
+    if (useVolumeTexture) {
+        shader.setUniformTexture("noise_volume", GL_TEXTURE_3D, volumeTexture, textureLocation);
+    } else {
+        shader.setUniformTexture("noise_atlas", atlasTexture, textureLocation);
+    }
+}
+
+glm::vec3 NoiseVolume::getSlice(float theta, float resolution, int fieldWidth, int fieldHeight) const {
+    // Same scaling as the CPU noise fields, converted to volume units
+    float step = resolution * 0.05f / PERIOD;
+    float phase = theta * 0.1f / PERIOD;
+    
+    // The volume repeats, so only the fraction matters; dropping the whole
+    // part keeps precision as the LFO phase keeps growing
+    phase -= floorf(phase);
+    
+    return glm::vec3(fieldWidth * step, fieldHeight * step, phase);
+}
+
+void NoiseVolume::uploadVolumeTexture(const std::vector<unsigned char>& voxels) {
+#ifndef TARGET_OPENGLES
+    glGenTextures(1, &volumeTexture);
+    glBindTexture(GL_TEXTURE_3D, volumeTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage3D(GL_TEXTURE_3D, 0, GL_R8, SIZE, SIZE, SIZE, 0, GL_RED, GL_UNSIGNED_BYTE, voxels.data());
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_3D, 0);
+    
+    allocated = volumeTexture != 0;
+#endif
+}
+
+void NoiseVolume::uploadAtlasTexture(const std::vector<unsigned char>& voxels) {
+    int atlasRows = (SIZE + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS;
+    ofPixels atlas;
+    atlas.allocate(ATLAS_COLUMNS * ATLAS_TILE, atlasRows * ATLAS_TILE, OF_PIXELS_GRAY);
+    unsigned char* pixels = atlas.getData();
+    int atlasWidth = atlas.getWidth();
+    
+    // Each tile holds one slice with the opposite edge copied around it,
+    // so bilinear filtering wraps without bleeding into the next tile
+    for (int z = 0; z < SIZE; z++) {
+        int tileX = (z % ATLAS_COLUMNS) * ATLAS_TILE;
+        int tileY = (z / ATLAS_COLUMNS) * ATLAS_TILE;
+        for (int ty = 0; ty < ATLAS_TILE; ty++) {
+            int y = (ty - 1 + SIZE) % SIZE;
+            const unsigned char* source = voxels.data() + ((size_t)z * SIZE + y) * SIZE;
+            unsigned char* target = pixels + (size_t)(tileY + ty) * atlasWidth + tileX;
+            for (int tx = 0; tx < ATLAS_TILE; tx++) {
+                target[tx] = source[(tx - 1 + SIZE) % SIZE];
+            }
+        }
+    }
+    
+    atlasTexture.allocate(atlas);
+    atlasTexture.loadData(atlas);
+    atlasTexture.setTextureMinMagFilter(GL_LINEAR, GL_LINEAR);
+    atlasTexture.setTextureWrap(GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
+    
+    allocated = atlasTexture.isAllocated();
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "ofMain.h"
+#include <atomic>
+#include <thread>
+
+// A tileable noise volume baked once and sampled by the displacement shader.
+// Each noise field becomes a slice picked by its LFO phase, so the per-frame
+// cost is a few uniforms. GL3 stores the volume as a 3D texture; GL2 and ES2
+// get a 2D atlas of slices with a wrapped border around each tile.
+class NoiseVolume {
+public:
+    NoiseVolume();
+    ~NoiseVolume();
+    
+    // Start baking on a worker thread, so startup doesn't wait for it
+    void setup();
+    
+    // Upload the volume once the bake is done (GL thread, cheap until then)
+    void update();
+    
+    // True once uploaded; false while baking or when this renderer can't hold it
+    bool isAllocated() const;
+    
+    // Bind the volume on a texture unit of the displacement shader
+    void bind(ofShader& shader, int textureLocation);
+    
+    // Texture scale (xy) and phase (z) of the slice a noise field would show,
+    // in volume units; the shader samples at (texCoords * 0.5 * xy, z)
+    glm::vec3 getSlice(float theta, float resolution, int fieldWidth, int fieldHeight) const;
+    
+    // Layout, mirrored by the constants in the displacement shaders. The
+    // shader shows half of a 90 pixel field, which at frequency f spans
+    // 90 * 0.5 * 0.05 * f = 2.25f lattice cells. 8 cells per period keep the
+    // repeat off screen up to f = 3.5, well past the MIDI range (1.0) plus
+    // audio modulation, and 12 voxels per cell keep the slices smooth
+    static constexpr int SIZE = 96;             // Voxels per side
+    static constexpr int PERIOD = 8;            // Noise lattice cells per side
+    static constexpr int ATLAS_COLUMNS = 12;    // Slices per atlas row
+    static constexpr int ATLAS_TILE = SIZE + 2; // Slice plus a wrapped border
+
+private:
+    void uploadVolumeTexture(const std::vector<unsigned char>& voxels);
+    void uploadAtlasTexture(const std::vector<unsigned char>& voxels);
+    
+    // Bake state, the voxels belong to the worker until `baked` is set
+    std::thread bakeThread;
+    std::atomic<bool> baked;
+    std::vector<unsigned char> voxels;
+    uint64_t bakeMicros;
+    bool uploaded;
+    
+    bool useVolumeTexture;
+    GLuint volumeTexture;
+    ofTexture atlasTexture;
+    bool allocated;
+};
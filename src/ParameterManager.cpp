@@ -1,4 +1,5 @@
 #include "ParameterManager.h"
+#include "NoiseGenerator.h"
 
 ParameterManager::ParameterManager() {
     // Initialize P-Lock arrays with zeros
@@ -14,6 +15,12 @@ ParameterManager::ParameterManager() {
     performanceScale = 50;
     noiseUpdateInterval = 4;
     highQualityEnabled = true;
+    meshCacheSize = 32;
+    adaptiveResolutionEnabled = false;
+    targetFrameRate = 30;
+    minScale = 20;
+    noiseMode = NoiseMode::Cpu;
+    noiseQuality = NoiseQuality::Full;
 }
 
 void ParameterManager::setup() {
@@ -130,6 +137,9 @@ void ParameterManager::resetToDefaults() {
     yLfoShape = LfoShape::Sine;
     xLfoShape = LfoShape::Sine;
     zLfoShape = LfoShape::Sine;
+    fbmOctaves = 4;
+    fbmLacunarity = 2.0f;
+    fbmGain = 0.5f;
     yRingModEnabled = false;
     xRingModEnabled = false;
     zRingModEnabled = false;
@@ -147,6 +157,7 @@ void ParameterManager::resetToDefaults() {
     // Reset mesh
     meshType = MeshType::TriangleGrid;
     strokeWeight = 1.0f;
+    markMeshDirty();
     
     // Clear P-Lock system
     clearAllLocks();
@@ -172,6 +183,14 @@ void ParameterManager::loadFromXml(ofxXmlSettings& xml) {
     performanceScale = xml.getValue("performance:scale", 50);
     noiseUpdateInterval = xml.getValue("performance:noiseUpdateInterval", 4);
     highQualityEnabled = xml.getValue("performance:highQuality", true);
+    meshCacheSize = xml.getValue("performance:meshCacheSize", 32);
+    adaptiveResolutionEnabled = xml.getValue("performance:adaptive", false);
+    targetFrameRate = xml.getValue("performance:targetFps", 30);
+    minScale = xml.getValue("performance:minScale", 20);
+    int tempNoiseMode = xml.getValue("performance:noiseMode", 0);
+    noiseMode = static_cast<NoiseMode>(tempNoiseMode);
+    int tempNoiseQuality = xml.getValue("performance:noiseQuality", 0);
+    noiseQuality = static_cast<NoiseQuality>(ofClamp(tempNoiseQuality, 0, 2));
     
     // Load video settings
     videoDevicePath = xml.getValue("video:devicePath", "/dev/video0");
@@ -216,6 +235,10 @@ void ParameterManager::loadFromXml(ofxXmlSettings& xml) {
     tempShape = xml.getValue("lfo:zShape", 0);
     zLfoShape = static_cast<LfoShape>(tempShape);
     
+    fbmOctaves = ofClamp(xml.getValue("lfo:fbmOctaves", 4), 1, NoiseGenerator::MAX_OCTAVES);
+    setFbmLacunarity(xml.getValue("lfo:fbmLacunarity", 2.0f));
+    setFbmGain(xml.getValue("lfo:fbmGain", 0.5f));
+    
     yRingModEnabled = xml.getValue("lfo:yRingMod", false);
     xRingModEnabled = xml.getValue("lfo:xRingMod", false);
     zRingModEnabled = xml.getValue("lfo:zRingMod", false);
@@ -234,6 +257,11 @@ void ParameterManager::loadFromXml(ofxXmlSettings& xml) {
     int tempMeshType = xml.getValue("mesh:type", 0);
     meshType = static_cast<MeshType>(tempMeshType);
     strokeWeight = xml.getValue("mesh:strokeWeight", 1.0f);
+    int tempRenderMode = xml.getValue("mesh:renderMode", 0);
+    meshRenderMode = static_cast<MeshRenderMode>(tempRenderMode);
+    
+    // Any loaded mesh setting may differ from what was built before
+    markMeshDirty();
     
     // Load P-Lock data if available
     xml.pushTag("plocks");
@@ -332,6 +360,12 @@ void ParameterManager::saveToXml(ofxXmlSettings& xml) const {
     xml.setValue("performance:scale", performanceScale);
     xml.setValue("performance:noiseUpdateInterval", noiseUpdateInterval);
     xml.setValue("performance:highQuality", highQualityEnabled);
+    xml.setValue("performance:meshCacheSize", meshCacheSize);
+    xml.setValue("performance:adaptive", adaptiveResolutionEnabled);
+    xml.setValue("performance:targetFps", targetFrameRate);
+    xml.setValue("performance:minScale", minScale);
+    xml.setValue("performance:noiseMode", static_cast<int>(noiseMode));
+    xml.setValue("performance:noiseQuality", static_cast<int>(noiseQuality));
     
     // Basic parameters
     xml.setValue("parameters:lumaKeyLevel", lumaKeyLevel);
@@ -363,6 +397,9 @@ void ParameterManager::saveToXml(ofxXmlSettings& xml) const {
     xml.setValue("lfo:yShape", static_cast<int>(yLfoShape));
     xml.setValue("lfo:xShape", static_cast<int>(xLfoShape));
     xml.setValue("lfo:zShape", static_cast<int>(zLfoShape));
+    xml.setValue("lfo:fbmOctaves", fbmOctaves);
+    xml.setValue("lfo:fbmLacunarity", fbmLacunarity);
+    xml.setValue("lfo:fbmGain", fbmGain);
     xml.setValue("lfo:yRingMod", yRingModEnabled);
     xml.setValue("lfo:xRingMod", xRingModEnabled);
     xml.setValue("lfo:zRingMod", zRingModEnabled);
@@ -380,6 +417,7 @@ void ParameterManager::saveToXml(ofxXmlSettings& xml) const {
     // Mesh
     xml.setValue("mesh:type", static_cast<int>(meshType));
     xml.setValue("mesh:strokeWeight", strokeWeight);
+    xml.setValue("mesh:renderMode", static_cast<int>(meshRenderMode));
     
     // Video settings
     xml.setValue("video:devicePath", videoDevicePath);
@@ -569,7 +607,10 @@ int ParameterManager::getScale() const {
 }
 
 void ParameterManager::setScale(int value, bool recordable) {
-    scale = value;
+    if (value != scale) {
+        scale = value;
+        markMeshDirty();
+    }
     if (recordable) {
         // Note: For integer parameters, we'll convert to float for P-Lock system
         recordParameter(7, static_cast<float>(value));
@@ -738,6 +779,32 @@ void ParameterManager::setZLfoShape(LfoShape shape) {
     zLfoShape = shape;
 }
 
+int ParameterManager::getFbmOctaves() const {
+    return fbmOctaves;
+}
+
+void ParameterManager::setFbmOctaves(int octaves) {
+    fbmOctaves = ofClamp(octaves, 1, NoiseGenerator::MAX_OCTAVES);
+}
+
+float ParameterManager::getFbmLacunarity() const {
+    return fbmLacunarity;
+}
+
+void ParameterManager::setFbmLacunarity(float lacunarity) {
+    // NaN fails every comparison, so it gets the default instead of a clamp
+    fbmLacunarity = std::isnan(lacunarity) ? 2.0f : ofClamp(lacunarity, NoiseGenerator::MIN_FBM_LACUNARITY,
+                                                           NoiseGenerator::MAX_FBM_LACUNARITY);
+}
+
+float ParameterManager::getFbmGain() const {
+    return fbmGain;
+}
+
+void ParameterManager::setFbmGain(float gain) {
+    fbmGain = std::isnan(gain) ? 0.5f : ofClamp(gain, NoiseGenerator::MIN_FBM_GAIN, 1.0f);
+}
+
 bool ParameterManager::isYRingModEnabled() const {
     return yRingModEnabled;
 }
@@ -833,7 +900,21 @@ MeshType ParameterManager::getMeshType() const {
 }
 
 void ParameterManager::setMeshType(MeshType type) {
-    meshType = type;
+    if (type != meshType) {
+        meshType = type;
+        markMeshDirty();
+    }
+}
+
+MeshRenderMode ParameterManager::getMeshRenderMode() const {
+    return meshRenderMode;
+}
+
+void ParameterManager::setMeshRenderMode(MeshRenderMode mode) {
+    if (mode != meshRenderMode) {
+        meshRenderMode = mode;
+        markMeshDirty();
+    }
 }
 
 float ParameterManager::getStrokeWeight() const {
@@ -850,7 +931,10 @@ bool ParameterManager::isPerformanceModeEnabled() const {
 }
 
 void ParameterManager::setPerformanceModeEnabled(bool enabled) {
-    performanceModeEnabled = enabled;
+    if (enabled != performanceModeEnabled) {
+        performanceModeEnabled = enabled;
+        markMeshDirty();
+    }
 }
 
 int ParameterManager::getPerformanceScale() const {
@@ -858,7 +942,10 @@ int ParameterManager::getPerformanceScale() const {
 }
 
 void ParameterManager::setPerformanceScale(int scale) {
-    performanceScale = scale;
+    if (scale != performanceScale) {
+        performanceScale = scale;
+        markMeshDirty();
+    }
 }
 
 int ParameterManager::getNoiseUpdateInterval() const {
@@ -877,6 +964,65 @@ void ParameterManager::setHighQualityEnabled(bool enabled) {
     highQualityEnabled = enabled;
 }
 
+int ParameterManager::getMeshCacheSize() const {
+    return meshCacheSize;
+}
+
+void ParameterManager::setMeshCacheSize(int megabytes) {
+    meshCacheSize = megabytes;
+}
+
+unsigned int ParameterManager::getMeshRevision() const {
+    return meshRevision;
+}
+
+void ParameterManager::markMeshDirty() {
+    meshRevision++;
+}
+
+bool ParameterManager::isAdaptiveResolutionEnabled() const {
+    return adaptiveResolutionEnabled;
+}
+
+void ParameterManager::setAdaptiveResolutionEnabled(bool enabled) {
+    if (enabled != adaptiveResolutionEnabled) {
+        adaptiveResolutionEnabled = enabled;
+        markMeshDirty();
+    }
+}
+
+int ParameterManager::getTargetFrameRate() const {
+    return targetFrameRate;
+}
+
+void ParameterManager::setTargetFrameRate(int fps) {
+    targetFrameRate = fps;
+}
+
+int ParameterManager::getMinScale() const {
+    return minScale;
+}
+
+void ParameterManager::setMinScale(int scale) {
+    minScale = scale;
+}
+
+NoiseMode ParameterManager::getNoiseMode() const {
+    return noiseMode;
+}
+
+void ParameterManager::setNoiseMode(NoiseMode mode) {
+    noiseMode = mode;
+}
+
+NoiseQuality ParameterManager::getNoiseQuality() const {
+    return noiseQuality;
+}
+
+void ParameterManager::setNoiseQuality(NoiseQuality quality) {
+    noiseQuality = quality;
+}
+
 //---------------------------------
 void ParameterManager::addMidiMapping(const ParameterManager::MidiMapping& mapping) {
     // Check if mapping already exists
@@ -18,12 +18,35 @@ enum class MeshType {
     TriangleWireframe
 };
 
-// Enum for LFO shapes
+// Enum for how the mesh is fed to the GPU
+enum class MeshRenderMode {
+    VertexBuffer,   // Generated on the CPU and drawn from a VBO
+    Procedural,     // Generated in the vertex shader from gl_VertexID (GL3 only)
+    Instanced       // One unit cell instanced across the grid (GL3 only)
+};
+
+// Enum for where the Perlin LFO noise comes from
+enum class NoiseMode {
+    Cpu,            // Noise images filled by the CPU worker pool
+    Shader,         // Noise fields rendered into FBOs each frame
+    Volume          // Slices of a tileable volume baked once at startup
+};
+
+// Enum for how densely the CPU noise lattice is evaluated; the texture's
+// linear filtering interpolates between the samples
+enum class NoiseQuality {
+    Full,           // One noise sample per noise texel
+    Half,           // Every 2nd texel per axis, 1/4 of the evaluations
+    Quarter         // Every 4th texel per axis, 1/16 of the evaluations
+};
+
+// Enum for LFO shapes, in the order of the shader's shape uniforms
 enum class LfoShape {
     Sine,
     Square,
-    Triangle,
-    Sawtooth
+    Sawtooth,
+    Noise,          // Single octave Perlin noise field
+    Fractal         // Multi-octave (fBm) noise field
 };
 
 class ParameterManager {
@@ -69,6 +92,30 @@ public:
     bool isHighQualityEnabled() const;
     void setHighQualityEnabled(bool enabled);
     
+    int getMeshCacheSize() const;
+    void setMeshCacheSize(int megabytes);
+    
+    // Bumped whenever a setting that changes the generated mesh changes
+    unsigned int getMeshRevision() const;
+    
+    // Adaptive resolution settings
+    bool isAdaptiveResolutionEnabled() const;
+    void setAdaptiveResolutionEnabled(bool enabled);
+    
+    int getTargetFrameRate() const;
+    void setTargetFrameRate(int fps);
+    
+    int getMinScale() const;
+    void setMinScale(int scale);
+    
+    // Where the Perlin LFO noise is generated
+    NoiseMode getNoiseMode() const;
+    void setNoiseMode(NoiseMode mode);
+    
+    // Noise lattice density, applied when the noise texture is allocated
+    NoiseQuality getNoiseQuality() const;
+    void setNoiseQuality(NoiseQuality quality);
+    
     // Parameter access (getters/setters)
     
     // Video device settings
@@ -167,6 +214,16 @@ public:
     LfoShape getZLfoShape() const;
     void setZLfoShape(LfoShape shape);
     
+    // Fractal noise shape: octave count, frequency and amplitude ratios
+    int getFbmOctaves() const;
+    void setFbmOctaves(int octaves);
+    
+    float getFbmLacunarity() const;
+    void setFbmLacunarity(float lacunarity);
+    
+    float getFbmGain() const;
+    void setFbmGain(float gain);
+    
     bool isYRingModEnabled() const;
     void setYRingModEnabled(bool enabled);
     
@@ -205,6 +262,9 @@ public:
     MeshType getMeshType() const;
     void setMeshType(MeshType type);
     
+    MeshRenderMode getMeshRenderMode() const;
+    void setMeshRenderMode(MeshRenderMode mode);
+    
     float getStrokeWeight() const;
     void setStrokeWeight(float weight);
     
@@ -249,6 +309,13 @@ private:
     int performanceScale = 50;  // Reduced scale when performance mode is on
     int noiseUpdateInterval = 4;  // Update noise every N frames
     bool highQualityEnabled = true;  // High quality rendering
+    int meshCacheSize = 32;  // Memory budget for cached meshes in MB
+    unsigned int meshRevision = 0;  // See getMeshRevision()
+    bool adaptiveResolutionEnabled = false;  // Scale mesh resolution to hold the target frame rate
+    int targetFrameRate = 30;  // Frame rate the adaptive resolution aims for
+    int minScale = 20;  // Lowest resolution the adaptive controller steps down to
+    NoiseMode noiseMode = NoiseMode::Cpu;  // Falls back to the CPU when unsupported
+    NoiseQuality noiseQuality = NoiseQuality::Full;  // Coarser tiers are upsampled by GL_LINEAR
     
     // Video device settings
     std::string videoDevicePath = "/dev/video0";
@@ -288,6 +355,9 @@ private:
     LfoShape yLfoShape = LfoShape::Sine;
     LfoShape xLfoShape = LfoShape::Sine;
     LfoShape zLfoShape = LfoShape::Sine;
+    int fbmOctaves = 4;
+    float fbmLacunarity = 2.0f;
+    float fbmGain = 0.5f;
     bool yRingModEnabled = false;
     bool xRingModEnabled = false;
     bool zRingModEnabled = false;
@@ -304,6 +374,7 @@ private:
     
     // Mesh
     MeshType meshType = MeshType::TriangleGrid;
+    MeshRenderMode meshRenderMode = MeshRenderMode::VertexBuffer;
     float strokeWeight = 1.0f;
     
     // P-Lock system
@@ -315,5 +386,6 @@ private:
     
     // Helper methods
     void recordParameter(int paramIndex, float value);
+    void markMeshDirty();
     
 };
@@ -0,0 +1,275 @@
+#include "PixelFormatConverter.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define CONVERTER_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define CONVERTER_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+inline unsigned char clampByte(int value) {
+    return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+// BT.601 limited range in 8.8 fixed point
+inline void storeRgba(unsigned char* dst, int y, int u, int v) {
+    int c = 298 * (y - 16);
+    int d = u - 128;
+    int e = v - 128;
+    dst[0] = clampByte((c + 409 * e + 128) >> 8);
+    dst[1] = clampByte((c - 100 * d - 208 * e + 128) >> 8);
+    dst[2] = clampByte((c + 516 * d + 128) >> 8);
+    dst[3] = 255;
+}
+
+// Byte offsets within a 4:2:2 macropixel
+struct PackedLayout {
+    int y0;
+    int u;
+    int y1;
+    int v;
+};
+
+const PackedLayout YUYV_LAYOUT = {0, 1, 2, 3};
+const PackedLayout UYVY_LAYOUT = {1, 0, 3, 2};
+
+// Scalar rows start at `first`, so they can finish what a vector kernel left
+void packedRowScalar(const unsigned char* in, unsigned char* out, int first, int width,
+                     const PackedLayout& layout) {
+    for (int x = first; x < width; x += 2) {
+        const unsigned char* macropixel = in + x * 2;
+        storeRgba(out + x * 4, macropixel[layout.y0], macropixel[layout.u], macropixel[layout.v]);
+        if (x + 1 < width) {
+            storeRgba(out + x * 4 + 4, macropixel[layout.y1], macropixel[layout.u], macropixel[layout.v]);
+        }
+    }
+}
+
+void nv12RowScalar(const unsigned char* luma, const unsigned char* chroma, unsigned char* out,
+                   int first, int width) {
+    for (int x = first; x < width; x++) {
+        const unsigned char* uv = chroma + (x & ~1);
+        storeRgba(out + x * 4, luma[x], uv[0], uv[1]);
+    }
+}
+
+#if CONVERTER_SSE2
+// Two macropixels per 64-bit half after widening to 16 bits; the
+// shuffles pair each luma with U (YU) and with V (YV)
+const int YUYV_YU = _MM_SHUFFLE(1, 2, 1, 0);
+const int YUYV_YV = _MM_SHUFFLE(3, 2, 3, 0);
+const int UYVY_YU = _MM_SHUFFLE(0, 3, 0, 1);
+const int UYVY_YV = _MM_SHUFFLE(2, 3, 2, 1);
+
+// Convert 8 pixels: `halves` holds four macropixels widened to 16 bits.
+// madd does each channel's 298 * (Y - 16) + k * chroma in 32 bits, so
+// the result is exactly the scalar one
+template<int YU, int YV>
+inline void convertPixelsSSE2(const __m128i halves[2], unsigned char* out) {
+    const __m128i bias = _mm_set_epi16(128, 16, 128, 16, 128, 16, 128, 16);
+    const __m128i redCoeffs = _mm_set_epi16(409, 298, 409, 298, 409, 298, 409, 298);
+    const __m128i greenUCoeffs = _mm_set_epi16(-100, 298, -100, 298, -100, 298, -100, 298);
+    const __m128i greenVCoeffs = _mm_set_epi16(-208, 0, -208, 0, -208, 0, -208, 0);
+    const __m128i blueCoeffs = _mm_set_epi16(516, 298, 516, 298, 516, 298, 516, 298);
+    const __m128i round = _mm_set1_epi32(128);
+    
+    __m128i red[2], green[2], blue[2];
+    for (int i = 0; i < 2; i++) {
+        __m128i yu = _mm_sub_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(halves[i], YU), YU), bias);
+        __m128i yv = _mm_sub_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(halves[i], YV), YV), bias);
+        
+        red[i] = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yv, redCoeffs), round), 8);
+        green[i] = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(yu, greenUCoeffs),
+                                                              _mm_madd_epi16(yv, greenVCoeffs)), round), 8);
+        blue[i] = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yu, blueCoeffs), round), 8);
+    }
+    
+    // Narrow with saturation, which is the clamp to [0, 255]
+    __m128i redBlue = _mm_packus_epi16(_mm_packs_epi32(red[0], red[1]), _mm_packs_epi32(blue[0], blue[1]));
+    __m128i greenAlpha = _mm_packus_epi16(_mm_packs_epi32(green[0], green[1]), _mm_set1_epi16(255));
+    
+    // Interleave into R G B A
+    __m128i redGreen = _mm_unpacklo_epi8(redBlue, greenAlpha);
+    __m128i blueAlpha = _mm_unpackhi_epi8(redBlue, greenAlpha);
+    _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi16(redGreen, blueAlpha));
+    _mm_storeu_si128((__m128i*)(out + 16), _mm_unpackhi_epi16(redGreen, blueAlpha));
+}
+
+// Vector kernels return how many pixels they converted; the scalar row finishes the rest
+template<int YU, int YV>
+int packedRowSSE2(const unsigned char* in, unsigned char* out, int width) {
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m128i packed = _mm_loadu_si128((const __m128i*)(in + x * 2));
+        __m128i halves[2] = {_mm_unpacklo_epi8(packed, zero), _mm_unpackhi_epi8(packed, zero)};
+        convertPixelsSSE2<YU, YV>(halves, out + x * 4);
+    }
+    return x;
+}
+
+int nv12RowSSE2(const unsigned char* luma, const unsigned char* chroma, unsigned char* out, int width) {
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        // Interleaving 8 Y with 4 UV pairs gives YUYV order
+        __m128i packed = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(luma + x)),
+                                           _mm_loadl_epi64((const __m128i*)(chroma + x)));
+        __m128i halves[2] = {_mm_unpacklo_epi8(packed, zero), _mm_unpackhi_epi8(packed, zero)};
+        convertPixelsSSE2<YUYV_YU, YUYV_YV>(halves, out + x * 4);
+    }
+    return x;
+}
+#endif
+
+#if CONVERTER_NEON
+// One channel of 8 pixels: (298 * (Y - 16) + chroma + 128) >> 8 in 32
+// bits like the scalar path, where `chroma` already holds the rounding
+inline uint8x8_t channelNEON(int16x8_t luma, int32x4_t chromaLow, int32x4_t chromaHigh) {
+    int32x4_t low = vaddq_s32(vmull_n_s16(vget_low_s16(luma), 298), chromaLow);
+    int32x4_t high = vaddq_s32(vmull_n_s16(vget_high_s16(luma), 298), chromaHigh);
+    // Narrowing with saturation is the clamp to [0, 255]
+    return vqmovun_s16(vcombine_s16(vqmovn_s32(vshrq_n_s32(low, 8)), vqmovn_s32(vshrq_n_s32(high, 8))));
+}
+
+// Convert 16 pixels: 8 even and 8 odd lumas, and the U and V they share
+inline void convertPixelsNEON(uint8x8_t evenY, uint8x8_t oddY, uint8x8_t u, uint8x8_t v, unsigned char* out) {
+    int16x8_t even = vreinterpretq_s16_u16(vsubl_u8(evenY, vdup_n_u8(16)));
+    int16x8_t odd = vreinterpretq_s16_u16(vsubl_u8(oddY, vdup_n_u8(16)));
+    int16x8_t d = vreinterpretq_s16_u16(vsubl_u8(u, vdup_n_u8(128)));
+    int16x8_t e = vreinterpretq_s16_u16(vsubl_u8(v, vdup_n_u8(128)));
+    const int32x4_t round = vdupq_n_s32(128);
+    
+    int32x4_t red[2], green[2], blue[2];
+    for (int i = 0; i < 2; i++) {
+        int16x4_t di = i == 0 ? vget_low_s16(d) : vget_high_s16(d);
+        int16x4_t ei = i == 0 ? vget_low_s16(e) : vget_high_s16(e);
+        red[i] = vmlal_n_s16(round, ei, 409);
+        green[i] = vmlal_n_s16(vmlal_n_s16(round, di, -100), ei, -208);
+        blue[i] = vmlal_n_s16(round, di, 516);
+    }
+    
+    // Zipping even and odd pixels puts them back in order
+    uint8x8x2_t r = vzip_u8(channelNEON(even, red[0], red[1]), channelNEON(odd, red[0], red[1]));
+    uint8x8x2_t g = vzip_u8(channelNEON(even, green[0], green[1]), channelNEON(odd, green[0], green[1]));
+    uint8x8x2_t b = vzip_u8(channelNEON(even, blue[0], blue[1]), channelNEON(odd, blue[0], blue[1]));
+    uint8x8_t alpha = vdup_n_u8(255);
+    for (int i = 0; i < 2; i++) {
+        uint8x8x4_t rgba = {{r.val[i], g.val[i], b.val[i], alpha}};
+        vst4_u8(out + i * 32, rgba);
+    }
+}
+
+// Vector kernels return how many pixels they converted; the scalar row
+// finishes the rest. The loads split macropixels into planes by layout
+template<int Y0, int U, int Y1, int V>
+int packedRowNEON(const unsigned char* in, unsigned char* out, int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        uint8x8x4_t packed = vld4_u8(in + x * 2);
+        convertPixelsNEON(packed.val[Y0], packed.val[Y1], packed.val[U], packed.val[V], out + x * 4);
+    }
+    return x;
+}
+
+int nv12RowNEON(const unsigned char* luma, const unsigned char* chroma, unsigned char* out, int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        uint8x8x2_t y = vld2_u8(luma + x);
+        uint8x8x2_t uv = vld2_u8(chroma + x);
+        convertPixelsNEON(y.val[0], y.val[1], uv.val[0], uv.val[1], out + x * 4);
+    }
+    return x;
+}
+#endif
+
+bool convert(ofPixelFormat format, const unsigned char* src, int srcStride,
+             unsigned char* dst, int width, int height, bool useVector) {
+#if !CONVERTER_SSE2 && !CONVERTER_NEON
+    useVector = false;
+#endif
+    
+    for (int y = 0; y < height; y++) {
+        const unsigned char* in = src + (size_t)y * srcStride;
+        unsigned char* out = dst + (size_t)y * width * 4;
+        int done = 0;
+        
+        switch (format) {
+            case OF_PIXELS_YUY2:
+#if CONVERTER_SSE2
+                if (useVector) done = packedRowSSE2<YUYV_YU, YUYV_YV>(in, out, width);
+#elif CONVERTER_NEON
+                if (useVector) done = packedRowNEON<0, 1, 2, 3>(in, out, width);
+#endif
+                packedRowScalar(in, out, done, width, YUYV_LAYOUT);
+                break;
+            
+            case OF_PIXELS_UYVY:
+#if CONVERTER_SSE2
+                if (useVector) done = packedRowSSE2<UYVY_YU, UYVY_YV>(in, out, width);
+#elif CONVERTER_NEON
+                if (useVector) done = packedRowNEON<1, 0, 3, 2>(in, out, width);
+#endif
+                packedRowScalar(in, out, done, width, UYVY_LAYOUT);
+                break;
+            
+            case OF_PIXELS_NV12: {
+                // One UV row per two Y rows, after the whole Y plane
+                const unsigned char* chroma = src + (size_t)height * srcStride + (size_t)(y / 2) * srcStride;
+#if CONVERTER_SSE2
+                if (useVector) done = nv12RowSSE2(in, chroma, out, width);
+#elif CONVERTER_NEON
+                if (useVector) done = nv12RowNEON(in, chroma, out, width);
+#endif
+                nv12RowScalar(in, chroma, out, done, width);
+                break;
+            }
+            
+            default:
+                return false;
+        }
+    }
+    
+    return true;
+}
+
+}
+
+bool PixelFormatConverter::isSupported(ofPixelFormat format) {
+    return format == OF_PIXELS_YUY2 || format == OF_PIXELS_UYVY || format == OF_PIXELS_NV12;
+}
+
+size_t PixelFormatConverter::getFrameSize(ofPixelFormat format, int stride, int height) {
+    switch (format) {
+        case OF_PIXELS_YUY2:
+        case OF_PIXELS_UYVY:
+            return (size_t)stride * height;
+        case OF_PIXELS_NV12:
+            return (size_t)stride * (height + (height + 1) / 2);
+        default:
+            return 0;
+    }
+}
+
+bool PixelFormatConverter::toRgba(ofPixelFormat format, const unsigned char* src, int srcStride,
+                                  unsigned char* dst, int width, int height) {
+    return convert(format, src, srcStride, dst, width, height, true);
+}
+
+bool PixelFormatConverter::toRgbaScalar(ofPixelFormat format, const unsigned char* src, int srcStride,
+                                        unsigned char* dst, int width, int height) {
+    return convert(format, src, srcStride, dst, width, height, false);
+}
+
+const char* PixelFormatConverter::getKernelName() {
+#if CONVERTER_SSE2
+    return "SSE2";
+#elif CONVERTER_NEON
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
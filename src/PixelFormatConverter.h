@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ofMain.h"
+
+/**
+ * @class PixelFormatConverter
+ * @brief Converts raw camera frames to RGBA on the CPU
+ *
+ * For capture paths where the frame can't go to the GPU untouched. Takes
+ * packed YUYV (OF_PIXELS_YUY2) and UYVY 4:2:2, and NV12 4:2:0 laid out
+ * as V4L2 delivers it: the interleaved UV plane directly follows the Y
+ * plane with the same stride. Colours use BT.601 limited-range
+ * coefficients, the encoding SD capture devices use.
+ *
+ * On x86 a row is converted 8 pixels per step with SSE2, and on ARM
+ * 16 pixels per step with NEON; other targets use the scalar reference,
+ * which both vector kernels match bit for bit.
+ */
+class PixelFormatConverter {
+public:
+    /**
+     * @return true for the formats toRgba() converts
+     */
+    static bool isSupported(ofPixelFormat format);
+    
+    /**
+     * Bytes a frame occupies in the source buffer
+     * @param format Source format
+     * @param stride Bytes per source row (of the Y plane for NV12)
+     * @param height Frame height in pixels
+     * @return Frame size, or 0 for unsupported formats
+     */
+    static size_t getFrameSize(ofPixelFormat format, int stride, int height);
+    
+    /**
+     * Convert a frame to RGBA
+     *
+     * @param format Source format
+     * @param src First byte of the frame
+     * @param srcStride Bytes per source row (may include padding)
+     * @param dst Destination RGBA pixels, tightly packed
+     * @param width Frame width in pixels
+     * @param height Frame height in pixels
+     * @return false if the format is not supported
+     */
+    static bool toRgba(ofPixelFormat format, const unsigned char* src, int srcStride,
+                       unsigned char* dst, int width, int height);
+    
+    /**
+     * Same conversion one pixel at a time; the reference the vector
+     * kernels are checked against
+     */
+    static bool toRgbaScalar(ofPixelFormat format, const unsigned char* src, int srcStride,
+                             unsigned char* dst, int width, int height);
+    
+    /**
+     * Kernel picked for this CPU ("SSE2", "NEON" or "scalar")
+     */
+    static const char* getKernelName();
+};
@@ -0,0 +1,109 @@
+#include "ResolutionController.h"
+
+ResolutionController::ResolutionController(ParameterManager* paramManager)
+    : paramManager(paramManager), resolution(0), initialized(false),
+      averageFrameTime(0.0f), averageWorkTime(0.0f),
+      overBudgetFrames(0), underBudgetFrames(0), cooldownFrames(0),
+      upHoldFrames(BASE_UP_HOLD_FRAMES), frameCount(0), lastUpFrame(0), lastStepWasUp(false) {
+}
+
+void ResolutionController::update(float frameTime, float workTime) {
+    frameCount++;
+    
+    // The user's scale is the ceiling, the configured minimum the floor
+    int maxScale = std::max(1, paramManager->getScale());
+    int minScale = std::min(std::max(1, paramManager->getMinScale()), maxScale);
+    
+    if (!initialized) {
+        resolution = maxScale;
+        averageFrameTime = frameTime;
+        averageWorkTime = workTime;
+        initialized = true;
+        return;
+    }
+    
+    resolution = std::min(std::max(resolution, minScale), maxScale);
+    
+    averageFrameTime += (frameTime - averageFrameTime) * SMOOTHING;
+    averageWorkTime += (workTime - averageWorkTime) * SMOOTHING;
+    
+    float budget = getTargetFrameTime();
+    
+    // Frame time can't drop below the frame rate cap, so headroom is judged
+    // from the time actually spent working
+    if (averageFrameTime > budget * OVER_BUDGET_RATIO) {
+        overBudgetFrames++;
+        underBudgetFrames = 0;
+    } else if (averageWorkTime < budget * HEADROOM_RATIO) {
+        underBudgetFrames++;
+        overBudgetFrames = 0;
+    } else {
+        overBudgetFrames = 0;
+        underBudgetFrames = 0;
+    }
+    
+    if (cooldownFrames > 0) {
+        cooldownFrames--;
+        return;
+    }
+    
+    if (overBudgetFrames >= DOWN_HOLD_FRAMES && resolution > minScale) {
+        // Stepping up just failed, wait longer before trying again
+        if (lastStepWasUp && frameCount - lastUpFrame < (uint64_t)(upHoldFrames + STEP_COOLDOWN_FRAMES * 2)) {
+            upHoldFrames = std::min(upHoldFrames * 2, MAX_UP_HOLD_FRAMES);
+        }
+        
+        step(std::max(minScale, (int)(resolution * 0.85f)));
+        lastStepWasUp = false;
+    } else if (underBudgetFrames >= upHoldFrames && resolution < maxScale) {
+        // Previous step up held, so go back to the normal hold time
+        if (lastStepWasUp) {
+            upHoldFrames = BASE_UP_HOLD_FRAMES;
+        }
+        
+        step(std::min(maxScale, resolution + std::max(1, resolution / 10)));
+        lastStepWasUp = true;
+        lastUpFrame = frameCount;
+    }
+}
+
+void ResolutionController::step(int newResolution) {
+    Decision decision;
+    decision.frame = frameCount;
+    decision.fromScale = resolution;
+    decision.toScale = newResolution;
+    decision.frameTime = averageFrameTime;
+    
+    history.push_front(decision);
+    if (history.size() > MAX_HISTORY) {
+        history.pop_back();
+    }
+    
+    ofLogVerbose("ResolutionController") << "Resolution " << resolution << " -> " << newResolution
+                                         << " at " << averageFrameTime * 1000.0f << "ms";
+    
+    resolution = newResolution;
+    overBudgetFrames = 0;
+    underBudgetFrames = 0;
+    cooldownFrames = STEP_COOLDOWN_FRAMES;
+}
+
+int ResolutionController::getResolution() const {
+    return initialized ? resolution : paramManager->getScale();
+}
+
+float ResolutionController::getAverageFrameTime() const {
+    return averageFrameTime;
+}
+
+float ResolutionController::getAverageWorkTime() const {
+    return averageWorkTime;
+}
+
+float ResolutionController::getTargetFrameTime() const {
+    return 1.0f / std::max(1, paramManager->getTargetFrameRate());
+}
+
+const std::deque<ResolutionController::Decision>& ResolutionController::getHistory() const {
+    return history;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ParameterManager.h"
+#include <deque>
+
+// Steps the mesh resolution up or down to hold the target frame rate.
+// Frame times are smoothed and a step only happens after the budget has been
+// missed (or beaten) for a while, with a cooldown so each new mesh can settle.
+class ResolutionController {
+public:
+    // One resolution change, kept for the debug overlay
+    struct Decision {
+        uint64_t frame;
+        int fromScale;
+        int toScale;
+        float frameTime;       // Smoothed frame time that triggered the step
+    };
+    
+    ResolutionController(ParameterManager* paramManager);
+    
+    // Feed once per frame: time between frames and time spent in update/draw
+    void update(float frameTime, float workTime);
+    
+    // Resolution the mesh should be built at
+    int getResolution() const;
+    
+    // Debug info
+    float getAverageFrameTime() const;
+    float getAverageWorkTime() const;
+    float getTargetFrameTime() const;
+    const std::deque<Decision>& getHistory() const;
+    
+private:
+    void step(int newResolution);
+    
+    // Controller tuning
+    static constexpr float SMOOTHING = 0.1f;          // EMA weight of the newest frame
+    static constexpr float OVER_BUDGET_RATIO = 1.15f; // Step down above this share of the budget
+    static constexpr float HEADROOM_RATIO = 0.6f;     // Step up when the work fits in this share
+    static constexpr int DOWN_HOLD_FRAMES = 15;
+    static constexpr int BASE_UP_HOLD_FRAMES = 60;
+    static constexpr int MAX_UP_HOLD_FRAMES = 960;
+    static constexpr int STEP_COOLDOWN_FRAMES = 30;
+    static constexpr size_t MAX_HISTORY = 5;
+    
+    ParameterManager* paramManager;
+    
+    int resolution;
+    bool initialized;
+    
+    // Smoothed timings in seconds
+    float averageFrameTime;
+    float averageWorkTime;
+    
+    // Hysteresis state
+    int overBudgetFrames;
+    int underBudgetFrames;
+    int cooldownFrames;
+    int upHoldFrames;          // Grows when stepping up keeps failing
+    uint64_t frameCount;
+    uint64_t lastUpFrame;
+    bool lastStepWasUp;
+    
+    std::deque<Decision> history;
+};
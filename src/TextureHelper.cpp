@@ -6,3 +6,106 @@
 //
 
 #include "TextureHelper.h"
+
+TextureStream::TextureStream()
+    : glFormat(GL_RGBA),
+#ifndef TARGET_OPENGLES
+      nextBuffer(0),
+#endif
+      pixelData(nullptr), textureId(0),
+      uploadCount(0), pixelReallocations(0), textureReallocations(0) {
+}
+
+void TextureStream::allocate(int width, int height, ofPixelFormat format) {
+    pixels.allocate(width, height, format);
+    pixels.set(0);
+    texture.allocate(pixels);
+    glFormat = ofGetGLFormat(pixels);
+
+#ifndef TARGET_OPENGLES
+    for (auto& buffer : pixelBuffers) {
+        buffer.allocate(pixels.getTotalBytes(), GL_STREAM_DRAW);
+    }
+    nextBuffer = 0;
+#endif
+    
+    pixelData = pixels.getData();
+    textureId = texture.getTextureData().textureID;
+}
+
+void TextureStream::update() {
+    // Anything that swapped the storage since allocate() counts as a reallocation
+    if (pixels.getData() != pixelData) {
+        pixelReallocations++;
+        pixelData = pixels.getData();
+    }
+    
+    upload(pixels.getData());
+}
+
+void TextureStream::loadData(const ofPixels& source) {
+    if (!isAllocated() || source.getWidth() != pixels.getWidth() ||
+        source.getHeight() != pixels.getHeight() || source.getPixelFormat() != pixels.getPixelFormat()) {
+        if (isAllocated()) {
+            textureReallocations++;
+        }
+        allocate(source.getWidth(), source.getHeight(), source.getPixelFormat());
+    }
+    
+    upload(source.getData());
+}
+
+void TextureStream::upload(const unsigned char* data) {
+#ifndef TARGET_OPENGLES
+    ofBufferObject& buffer = pixelBuffers[nextBuffer];
+    if (buffer.isAllocated()) {
+        // Fill the next buffer in the ring, then queue the transfer from it
+        nextBuffer = (nextBuffer + 1) % NUM_BUFFERS;
+        buffer.updateData(0, pixels.getTotalBytes(), data);
+        texture.loadData(buffer, glFormat, GL_UNSIGNED_BYTE);
+    } else {
+        texture.loadData(data, pixels.getWidth(), pixels.getHeight(), glFormat);
+    }
+#else
+    texture.loadData(data, pixels.getWidth(), pixels.getHeight(), glFormat);
+#endif
+    
+    if (texture.getTextureData().textureID != textureId) {
+        textureReallocations++;
+        textureId = texture.getTextureData().textureID;
+    }
+    
+    uploadCount++;
+}
+
+ofPixels& TextureStream::getPixels() {
+    return pixels;
+}
+
+ofTexture& TextureStream::getTexture() {
+    return texture;
+}
+
+int TextureStream::getWidth() const {
+    return pixels.getWidth();
+}
+
+int TextureStream::getHeight() const {
+    return pixels.getHeight();
+}
+
+bool TextureStream::isAllocated() const {
+    return pixels.isAllocated() && texture.isAllocated();
+}
+
+uint64_t TextureStream::getUploadCount() const {
+    return uploadCount;
+}
+
+uint64_t TextureStream::getPixelReallocations() const {
+    return pixelReallocations;
+}
+
+uint64_t TextureStream::getTextureReallocations() const {
+    return textureReallocations;
+}
@@ -80,3 +80,76 @@ public:
         }
     }
 };
+
+/**
+ * @class TextureStream
+ * @brief Pixels streamed into a texture of the same size
+ *
+ * The texture is allocated once and every upload after that reuses it.
+ * Desktop GL uploads through a small ring of pixel buffer objects: the
+ * copy into one buffer never waits for the GPU to finish reading the
+ * previous one, and glTexSubImage2D returns as soon as the transfer is
+ * queued, so the DMA overlaps with rendering. ES2 has no PBOs and falls
+ * back to a plain glTexSubImage2D. Counters track any reallocation so
+ * the steady state can be checked at runtime.
+ */
+class TextureStream {
+public:
+    TextureStream();
+    
+    /**
+     * Allocate the pixels, the texture and the upload buffers
+     */
+    void allocate(int width, int height, ofPixelFormat format);
+    
+    /**
+     * Push the stream's own pixels to the texture
+     */
+    void update();
+    
+    /**
+     * Push external pixels, such as a camera frame, straight to the
+     * texture without copying them into the stream's pixels first.
+     * Reallocates (and counts it) when the size or format changes.
+     */
+    void loadData(const ofPixels& source);
+    
+    ofPixels& getPixels();
+    ofTexture& getTexture();
+    int getWidth() const;
+    int getHeight() const;
+    bool isAllocated() const;
+    
+    /**
+     * Upload statistics; the reallocation counts stay at zero once the
+     * stream is allocated unless something resized the pixels or texture
+     */
+    uint64_t getUploadCount() const;
+    uint64_t getPixelReallocations() const;
+    uint64_t getTextureReallocations() const;
+    
+    /**
+     * Upload buffers in the ring; three keeps one being filled while the
+     * previous two may still be read by the GPU
+     */
+    static constexpr int NUM_BUFFERS = 3;
+
+private:
+    void upload(const unsigned char* data);
+    
+    ofPixels pixels;
+    ofTexture texture;
+    int glFormat;
+#ifndef TARGET_OPENGLES
+    ofBufferObject pixelBuffers[NUM_BUFFERS];
+    int nextBuffer;
+#endif
+    
+    // What allocate() set up, to spot anything reallocating later
+    const unsigned char* pixelData;
+    GLuint textureId;
+    
+    uint64_t uploadCount;
+    uint64_t pixelReallocations;
+    uint64_t textureReallocations;
+};
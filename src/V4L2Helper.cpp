@@ -1,5 +1,16 @@
 #include "V4L2Helper.h"
 
+#ifdef TARGET_LINUX
+// ioctl that retries when a signal interrupts it
+static int xioctl(int fd, unsigned long request, void* arg) {
+    int result;
+    do {
+        result = ioctl(fd, request, arg);
+    } while (result < 0 && errno == EINTR);
+    return result;
+}
+#endif
+
 std::vector<V4L2Helper::VideoDevice> V4L2Helper::listDevices() {
     std::vector<VideoDevice> devices;
     
@@ -190,6 +201,34 @@ bool V4L2Helper::setFormat(const std::string& devicePath, uint32_t format, int w
 #endif
 }
 
+bool V4L2Helper::setFrameRate(const std::string& devicePath, int frameRate) {
+#ifdef TARGET_LINUX
+    int fd = open(devicePath.c_str(), O_RDWR);
+    if (fd < 0) {
+        ofLogError("V4L2Helper") << "Failed to open device: " << devicePath;
+        return false;
+    }
+    
+    struct v4l2_streamparm parm;
+    memset(&parm, 0, sizeof(parm));
+    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    parm.parm.capture.timeperframe.numerator = 1;
+    parm.parm.capture.timeperframe.denominator = frameRate;
+    
+    bool success = xioctl(fd, VIDIOC_S_PARM, &parm) >= 0;
+    if (!success) {
+        ofLogWarning("V4L2Helper") << "Failed to set " << frameRate << "fps for " << devicePath;
+    }
+    
+    close(fd);
+    return success;
+#else
+    ofLogNotice("V4L2Helper") << "Setting frame rate on non-Linux platform (will apply on camera init): "
+                            << frameRate << "fps";
+    return true;
+#endif
+}
+
 V4L2Helper::VideoFormat V4L2Helper::getCurrentFormat(const std::string& devicePath) {
     VideoFormat format;
     format.pixelFormat = 0x56595559; // Default to YUYV
@@ -228,6 +267,10 @@ uint32_t V4L2Helper::formatNameToCode(const std::string& formatName) {
     // Common format mapping for Linux
     if (formatName == "yuyv422" || formatName == "YUYV 4:2:2" || formatName == "YUYV") {
         return V4L2_PIX_FMT_YUYV;
+    } else if (formatName == "uyvy422" || formatName == "UYVY 4:2:2" || formatName == "UYVY") {
+        return V4L2_PIX_FMT_UYVY;
+    } else if (formatName == "nv12" || formatName == "Y/CbCr 4:2:0" || formatName == "NV12") {
+        return V4L2_PIX_FMT_NV12;
     } else if (formatName == "rgb565" || formatName == "RGB565") {
         return V4L2_PIX_FMT_RGB565;
     } else if (formatName == "bayer_rggb8" || formatName == "Bayer RGRG/GBGB") {
@@ -265,6 +308,8 @@ std::string V4L2Helper::formatCodeToName(uint32_t pixelFormat) {
     // Linux-specific format names
     switch (pixelFormat) {
         case V4L2_PIX_FMT_YUYV: return "YUYV 4:2:2";
+        case V4L2_PIX_FMT_UYVY: return "UYVY 4:2:2";
+        case V4L2_PIX_FMT_NV12: return "Y/CbCr 4:2:0";
         case V4L2_PIX_FMT_RGB565: return "RGB565";
         case V4L2_PIX_FMT_SRGGB8: return "Bayer RGRG/GBGB";
         case V4L2_PIX_FMT_SBGGR8: return "Bayer BGBG/GRGR";
@@ -284,6 +329,18 @@ std::string V4L2Helper::formatCodeToName(uint32_t pixelFormat) {
     return "Unknown";
 }
 
+ofPixelFormat V4L2Helper::formatCodeToPixelFormat(uint32_t pixelFormat) {
+#ifdef TARGET_LINUX
+    switch (pixelFormat) {
+        case V4L2_PIX_FMT_YUYV: return OF_PIXELS_YUY2;
+        case V4L2_PIX_FMT_UYVY: return OF_PIXELS_UYVY;
+        case V4L2_PIX_FMT_NV12: return OF_PIXELS_NV12;
+    }
+#endif
+    
+    return OF_PIXELS_UNKNOWN;
+}
+
 std::string V4L2Helper::formatCodeToFourCC(uint32_t pixelFormat) {
     char fourcc[5];
     fourcc[0] = pixelFormat & 0xFF;
@@ -293,3 +350,263 @@ std::string V4L2Helper::formatCodeToFourCC(uint32_t pixelFormat) {
     fourcc[4] = 0;
     return std::string(fourcc);
 }
+
+V4L2Capture::V4L2Capture()
+    : fd(-1), streaming(false), width(0), height(0), bytesPerLine(0), pixelFormat(0) {
+}
+
+V4L2Capture::~V4L2Capture() {
+    close();
+}
+
+bool V4L2Capture::open(const std::string& path, uint32_t format, int desiredWidth, int desiredHeight,
+                       int frameRate, int numBuffers) {
+    close();
+
+#ifdef TARGET_LINUX
+    // Non-blocking, so dequeueing never stalls; poll() does the waiting
+    fd = ::open(path.c_str(), O_RDWR | O_NONBLOCK);
+    if (fd < 0) {
+        ofLogError("V4L2Capture") << "Failed to open device: " << path;
+        return false;
+    }
+    devicePath = path;
+    
+    struct v4l2_capability cap;
+    memset(&cap, 0, sizeof(cap));
+    if (xioctl(fd, VIDIOC_QUERYCAP, &cap) < 0) {
+        ofLogError("V4L2Capture") << "Not a V4L2 device: " << path;
+        close();
+        return false;
+    }
+    
+    uint32_t caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS) ? cap.device_caps : cap.capabilities;
+    if (!(caps & V4L2_CAP_VIDEO_CAPTURE) || !(caps & V4L2_CAP_STREAMING)) {
+        ofLogError("V4L2Capture") << path << " can't stream video capture";
+        close();
+        return false;
+    }
+    
+    // Set the format; the driver adjusts the size to the nearest it supports
+    struct v4l2_format fmt;
+    memset(&fmt, 0, sizeof(fmt));
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = desiredWidth;
+    fmt.fmt.pix.height = desiredHeight;
+    fmt.fmt.pix.pixelformat = format;
+    fmt.fmt.pix.field = V4L2_FIELD_ANY;
+    
+    if (xioctl(fd, VIDIOC_S_FMT, &fmt) < 0 || fmt.fmt.pix.pixelformat != format) {
+        ofLogError("V4L2Capture") << path << " doesn't support " << V4L2Helper::formatCodeToFourCC(format);
+        close();
+        return false;
+    }
+    
+    width = fmt.fmt.pix.width;
+    height = fmt.fmt.pix.height;
+    bytesPerLine = fmt.fmt.pix.bytesperline;
+    pixelFormat = fmt.fmt.pix.pixelformat;
+    
+    // Frame rate is a request, not every driver honours it
+    struct v4l2_streamparm parm;
+    memset(&parm, 0, sizeof(parm));
+    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    parm.parm.capture.timeperframe.numerator = 1;
+    parm.parm.capture.timeperframe.denominator = frameRate;
+    if (xioctl(fd, VIDIOC_S_PARM, &parm) < 0) {
+        ofLogWarning("V4L2Capture") << "Failed to set " << frameRate << "fps, using the driver default";
+    }
+    
+    // Ask for the driver buffers and map each one
+    struct v4l2_requestbuffers request;
+    memset(&request, 0, sizeof(request));
+    request.count = numBuffers;
+    request.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    request.memory = V4L2_MEMORY_MMAP;
+    
+    if (xioctl(fd, VIDIOC_REQBUFS, &request) < 0 || request.count < 2) {
+        ofLogError("V4L2Capture") << path << " has no memory-mapped streaming buffers";
+        close();
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < request.count; i++) {
+        struct v4l2_buffer buffer;
+        memset(&buffer, 0, sizeof(buffer));
+        buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buffer.memory = V4L2_MEMORY_MMAP;
+        buffer.index = i;
+        
+        if (xioctl(fd, VIDIOC_QUERYBUF, &buffer) < 0) {
+            ofLogError("V4L2Capture") << "Failed to query buffer " << i;
+            close();
+            return false;
+        }
+        
+        void* start = mmap(nullptr, buffer.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, buffer.m.offset);
+        if (start == MAP_FAILED) {
+            ofLogError("V4L2Capture") << "Failed to map buffer " << i;
+            close();
+            return false;
+        }
+        buffers.push_back({start, buffer.length});
+    }
+    
+    // Hand every buffer to the driver and start streaming
+    for (size_t i = 0; i < buffers.size(); i++) {
+        if (!queueBuffer(i)) {
+            close();
+            return false;
+        }
+    }
+    
+    enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(fd, VIDIOC_STREAMON, &type) < 0) {
+        ofLogError("V4L2Capture") << "Failed to start streaming from " << path;
+        close();
+        return false;
+    }
+    streaming = true;
+    
+    ofLogNotice("V4L2Capture") << "Streaming " << V4L2Helper::formatCodeToFourCC(pixelFormat) << " "
+                               << width << "x" << height << " from " << path
+                               << " with " << buffers.size() << " buffers";
+    return true;
+#else
+    ofLogNotice("V4L2Capture") << "Native capture is only available on Linux";
+    return false;
+#endif
+}
+
+void V4L2Capture::close() {
+#ifdef TARGET_LINUX
+    if (streaming) {
+        enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        xioctl(fd, VIDIOC_STREAMOFF, &type);
+        streaming = false;
+    }
+    
+    for (auto& buffer : buffers) {
+        munmap(buffer.start, buffer.length);
+    }
+    
+    if (fd >= 0) {
+        // Release the driver buffers so the next open can ask for new ones
+        if (!buffers.empty()) {
+            struct v4l2_requestbuffers request;
+            memset(&request, 0, sizeof(request));
+            request.count = 0;
+            request.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            request.memory = V4L2_MEMORY_MMAP;
+            xioctl(fd, VIDIOC_REQBUFS, &request);
+        }
+        ::close(fd);
+    }
+#endif
+    
+    buffers.clear();
+    fd = -1;
+}
+
+bool V4L2Capture::isOpen() const {
+    return streaming;
+}
+
+bool V4L2Capture::grabFrame(Frame& frame, int timeoutMs) {
+#ifdef TARGET_LINUX
+    if (!streaming) return false;
+    
+    struct pollfd pollDescriptor = {fd, POLLIN, 0};
+    int ready = poll(&pollDescriptor, 1, timeoutMs);
+    if (ready <= 0 || !(pollDescriptor.revents & POLLIN)) {
+        if (ready < 0 && errno != EINTR) {
+            ofLogError("V4L2Capture") << "poll failed on " << devicePath;
+        }
+        return false;
+    }
+    
+    // Drain everything that is ready and keep only the newest frame
+    bool found = false;
+    while (true) {
+        struct v4l2_buffer buffer;
+        memset(&buffer, 0, sizeof(buffer));
+        buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buffer.memory = V4L2_MEMORY_MMAP;
+        
+        if (xioctl(fd, VIDIOC_DQBUF, &buffer) < 0) {
+            if (errno != EAGAIN) {
+                ofLogError("V4L2Capture") << "Failed to dequeue a frame from " << devicePath;
+            }
+            break;
+        }
+        
+        // The driver flags buffers it couldn't fill completely, hand those
+        // straight back rather than show a torn frame
+        if (buffer.flags & V4L2_BUF_FLAG_ERROR) {
+            queueBuffer(buffer.index);
+            continue;
+        }
+        
+        if (found) {
+            queueBuffer(frame.index);
+        }
+        
+        frame.data = static_cast<const unsigned char*>(buffers[buffer.index].start);
+        frame.bytesUsed = buffer.bytesused;
+        frame.sequence = buffer.sequence;
+        frame.timestampMicros = (uint64_t)buffer.timestamp.tv_sec * 1000000 + buffer.timestamp.tv_usec;
+        frame.index = buffer.index;
+        found = true;
+    }
+    
+    return found;
+#else
+    return false;
+#endif
+}
+
+void V4L2Capture::releaseFrame(Frame& frame) {
+    if (frame.index < 0) return;
+    
+    queueBuffer(frame.index);
+    frame.data = nullptr;
+    frame.index = -1;
+}
+
+bool V4L2Capture::queueBuffer(int index) {
+#ifdef TARGET_LINUX
+    struct v4l2_buffer buffer;
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buffer.memory = V4L2_MEMORY_MMAP;
+    buffer.index = index;
+    
+    if (xioctl(fd, VIDIOC_QBUF, &buffer) < 0) {
+        ofLogError("V4L2Capture") << "Failed to queue buffer " << index;
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+int V4L2Capture::getWidth() const {
+    return width;
+}
+
+int V4L2Capture::getHeight() const {
+    return height;
+}
+
+int V4L2Capture::getBytesPerLine() const {
+    return bytesPerLine;
+}
+
+uint32_t V4L2Capture::getPixelFormat() const {
+    return pixelFormat;
+}
+
+int V4L2Capture::getNumBuffers() const {
+    return buffers.size();
+}
@@ -6,6 +6,8 @@
 #ifdef TARGET_LINUX
 #include <linux/videodev2.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <poll.h>
 #include <fcntl.h>
 #include <unistd.h>
 #endif
@@ -64,6 +66,14 @@ public:
      */
     static bool setFormat(const std::string& devicePath, uint32_t format, int width, int height);
     
+    /**
+     * Set the capture frame rate for a device
+     * @param devicePath Path to the device
+     * @param frameRate Frames per second
+     * @return true if the device accepted a frame interval
+     */
+    static bool setFrameRate(const std::string& devicePath, int frameRate);
+    
     /**
      * Get the current format information for a device
      * @param devicePath Path to the device
@@ -85,6 +95,13 @@ public:
      */
     static std::string formatCodeToName(uint32_t pixelFormat);
     
+    /**
+     * Convert a pixel format code to the matching openFrameworks format
+     * @param pixelFormat Pixel format code
+     * @return OF_PIXELS_YUY2, OF_PIXELS_UYVY or OF_PIXELS_NV12, otherwise OF_PIXELS_UNKNOWN
+     */
+    static ofPixelFormat formatCodeToPixelFormat(uint32_t pixelFormat);
+    
     /**
      * Convert a pixel format code to a FourCC string
      * @param pixelFormat Pixel format code
@@ -92,3 +109,81 @@ public:
      */
     static std::string formatCodeToFourCC(uint32_t pixelFormat);
 };
+
+/**
+ * @class V4L2Capture
+ * @brief Streaming capture straight from a V4L2 device (Linux only)
+ *
+ * Frames are captured into driver buffers mapped into our address space
+ * (VIDIOC_REQBUFS / QBUF / DQBUF with mmap), so a frame is read where the
+ * driver wrote it. grabFrame() polls for new frames and always hands out the
+ * newest one, requeueing any older ones, which keeps latency at one frame.
+ * Buffers the driver flags with V4L2_BUF_FLAG_ERROR are requeued unseen. On other platforms open() fails and the caller falls back to ofVideoGrabber.
+ */
+class V4L2Capture {
+public:
+    struct Frame {
+        const unsigned char* data = nullptr;  // Mapped driver buffer, valid until releaseFrame()
+        size_t bytesUsed = 0;
+        uint32_t sequence = 0;                // Driver frame counter, gaps mean dropped frames
+        uint64_t timestampMicros = 0;
+        int index = -1;                       // Buffer index, for releaseFrame()
+    };
+    
+    V4L2Capture();
+    ~V4L2Capture();
+    
+    /**
+     * Open a device and start streaming
+     * @param devicePath Path to the device (e.g., /dev/video0)
+     * @param pixelFormat Pixel format code the frames must arrive in
+     * @param width Desired width; the driver may pick the nearest it supports
+     * @param height Desired height
+     * @param frameRate Desired frames per second
+     * @param numBuffers Driver buffers to request; more absorbs stalls, fewer lowers latency
+     * @return true if the device is streaming in the requested pixel format
+     */
+    bool open(const std::string& devicePath, uint32_t pixelFormat, int width, int height,
+              int frameRate, int numBuffers = 4);
+    
+    /**
+     * Stop streaming, unmap the buffers and close the device
+     */
+    void close();
+    
+    bool isOpen() const;
+    
+    /**
+     * Wait up to timeoutMs for a frame and take the newest one available
+     * @return true if a frame was taken; it must be handed back with releaseFrame()
+     */
+    bool grabFrame(Frame& frame, int timeoutMs = 0);
+    
+    /**
+     * Give a frame's buffer back to the driver
+     */
+    void releaseFrame(Frame& frame);
+    
+    int getWidth() const;
+    int getHeight() const;
+    int getBytesPerLine() const;
+    uint32_t getPixelFormat() const;
+    int getNumBuffers() const;
+
+private:
+    struct Buffer {
+        void* start;
+        size_t length;
+    };
+    
+    bool queueBuffer(int index);
+    
+    int fd;
+    std::string devicePath;
+    std::vector<Buffer> buffers;
+    bool streaming;
+    int width;
+    int height;
+    int bytesPerLine;
+    uint32_t pixelFormat;
+};
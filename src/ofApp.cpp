@@ -1,4 +1,5 @@
 #include "ofApp.h"
+#include <numeric>
 
 //--------------------------------------------------------------
 void ofApp::setup() {
@@ -23,6 +24,7 @@ void ofApp::setup() {
     // Initialize mesh generator
     meshGenerator = std::make_unique<MeshGenerator>(paramManager.get());
     meshGenerator->setup(width, height);
+    resolutionController = std::make_unique<ResolutionController>(paramManager.get());
     
     // Initialize audio reactivity manager BEFORE loading settings
     audioManager = std::make_unique<AudioReactivityManager>();
@@ -59,6 +61,11 @@ void ofApp::setup() {
         ofLogNotice("ofApp") << "Settings file not found, using defaults";
     }
     
+    // Adaptive resolution holds its own target frame rate
+    if (paramManager->isAdaptiveResolutionEnabled()) {
+        ofSetFrameRate(paramManager->getTargetFrameRate());
+    }
+    
     midiManager->setup();
     
     // Setup camera
@@ -89,20 +96,48 @@ void ofApp::setup() {
     // Update noise texture allocation based on performance mode (after settings are loaded)
     if (performanceMode) {
         // Use smaller noise textures for better performance
-        xNoiseImage.allocate(45, 30, OF_IMAGE_GRAYSCALE); // Half size in performance mode
-        yNoiseImage.allocate(45, 30, OF_IMAGE_GRAYSCALE);
-        zNoiseImage.allocate(45, 30, OF_IMAGE_GRAYSCALE);
+        noiseFieldWidth = 45; // Half size in performance mode
+        noiseFieldHeight = 30;
     } else {
         // Standard size
-        xNoiseImage.allocate(90, 60, OF_IMAGE_GRAYSCALE);
-        yNoiseImage.allocate(90, 60, OF_IMAGE_GRAYSCALE);
-        zNoiseImage.allocate(90, 60, OF_IMAGE_GRAYSCALE);
+        noiseFieldWidth = 90;
+        noiseFieldHeight = 60;
     }
     
+    // Coarser quality tiers evaluate a sparser lattice over the same noise
+    // domain, and GL_LINEAR fills in between when the shader samples it.
+    // The lattice is a whole number of aspect ratio units (90x60 is 3x2
+    // units of 30), so one scale fits both axes exactly, e.g. 24x16 at
+    // quarter quality instead of the 23x15 plain rounding would give
+    int latticeDivisor = 1 << static_cast<int>(paramManager->getNoiseQuality());
+    int unit = std::gcd(noiseFieldWidth, noiseFieldHeight);
+    int unitsX = noiseFieldWidth / unit;
+    int unitsY = noiseFieldHeight / unit;
+    int units = std::max((int)ceilf(unit / (float)latticeDivisor), (int)ceilf(2.0f / std::min(unitsX, unitsY)));
+    int latticeWidth = unitsX * units;
+    int latticeHeight = unitsY * units;
+    noiseLatticeScale = unit / (float)units;
+    noiseTexture.allocate(latticeWidth, latticeHeight, OF_PIXELS_RGBA);
+    ofLogNotice("ofApp") << "Noise lattice " << latticeWidth << "x" << latticeHeight
+                         << " for " << noiseFieldWidth << "x" << noiseFieldHeight << " fields";
+    
+    // X/Y/Z fields go in R/G/B; RGBA keeps every texel 4-byte aligned, which
+    // uploads without a driver-side repack on the Pi. Alpha is never written
+    noiseTexture.getPixels().setColor(ofColor(0, 0, 0, 255));
+    
     // Ensure texture settings are correct for shaders
-    xNoiseImage.getTexture().setTextureMinMagFilter(GL_LINEAR, GL_LINEAR);
-    yNoiseImage.getTexture().setTextureMinMagFilter(GL_LINEAR, GL_LINEAR);
-    zNoiseImage.getTexture().setTextureMinMagFilter(GL_LINEAR, GL_LINEAR);
+    noiseTexture.getTexture().setTextureMinMagFilter(GL_LINEAR, GL_LINEAR);
+    
+    // Fill the first noise fields up front so the textures start valid
+    noiseGenerator = std::make_unique<NoiseGenerator>();
+    noiseGenerator->setup();
+    startNoiseFields();
+    noiseGenerator->wait();
+    uploadNoiseFields();
+    
+    // Optional shader noise and baked volume, the CPU fields stay as the fallback
+    setupGpuNoise();
+    noiseVolume.setup();
     
     // Setup audio reactivity
     setupAudioReactivity();
@@ -112,6 +147,8 @@ void ofApp::setup() {
 
 //--------------------------------------------------------------
 void ofApp::update() {
+    frameStartMicros = ofGetElapsedTimeMicros();
+    
     // Update subsystems
     midiManager->update();
     paramManager->update();
@@ -126,32 +163,43 @@ void ofApp::update() {
     
     // Update noise images with performance considerations
     bool performanceMode = paramManager->isPerformanceModeEnabled();
-    int updateInterval = performanceMode ? paramManager->getNoiseUpdateInterval() : 2;
+    int updateInterval = performanceMode ? paramManager->getNoiseUpdateInterval() : 1;
 
-    // Only update noise textures every N frames based on performance settings
-    if (ofGetFrameNum() % updateInterval == 0) {
-        xNoiseImage = generatePerlinNoise(xLfoArg, paramManager->getXFrequency(), xNoiseImage);
-        
-        // In performance mode, stagger updates to avoid CPU spikes
-        if (!performanceMode || ofGetFrameNum() % (updateInterval * 2) == 0) {
-            yNoiseImage = generatePerlinNoise(yLfoArg, paramManager->getYFrequency(), yNoiseImage);
-        }
-        
-        if (!performanceMode || ofGetFrameNum() % (updateInterval * 3) == 0) {
-            zNoiseImage = generatePerlinNoise(zLfoArg, paramManager->getZFrequency(), zNoiseImage);
+    // Picks up the volume once its background bake is done
+    noiseVolume.update();
+    
+    // The volume has a single octave, so say once when fractal axes turn it off
+    bool volumeFallback = paramManager->getNoiseMode() == NoiseMode::Volume && usesFractalShape();
+    if (volumeFallback != noiseVolumeFallback) {
+        noiseVolumeFallback = volumeFallback;
+        if (volumeFallback) {
+            ofLogNotice("ofApp") << "Noise volume has no fractal octaves, using "
+                                 << getNoiseModeName(getActiveNoiseMode()) << " while an axis is fractal";
         }
     }
     
+    // The baked volume needs no per-frame work, the shader slices it by phase
+    NoiseMode noiseMode = getActiveNoiseMode();
+    if (noiseMode == NoiseMode::Shader) {
+        // Rendered straight into the texture, no CPU work and no upload
+        renderNoiseFields();
+    }
+    // Only update noise textures every N frames based on performance settings
+    else if (noiseMode == NoiseMode::Cpu && ofGetFrameNum() % updateInterval == 0) {
+        // Upload the fields the pool filled during the last frame, then queue
+        // the next ones so they compute while this frame renders
+        noiseGenerator->wait();
+        uploadNoiseFields();
+        startNoiseFields();
+    }
+    
     // Update LFO arguments
     xLfoArg += paramManager->getXLfoArg();
     yLfoArg += paramManager->getYLfoArg();
     zLfoArg += paramManager->getZLfoArg();
     
-    // Update mesh if needed
-    int currentScale = paramManager->getScale();
-    if (currentScale != meshGenerator->getMesh().getNumVertices() / 6) { // Triangle mode has 6 vertices per grid cell
-        meshGenerator->updateMeshFromParameters();
-    }
+    // Rebuild the mesh when mesh parameters changed, and swap in finished meshes
+    meshGenerator->update();
     
 //    audioManager->update();
     
@@ -167,6 +215,12 @@ void ofApp::update() {
 
     performanceMetrics[metricIndex] = frameDuration;
     metricIndex = (metricIndex + 1) % 60;
+    
+    // Let the adaptive controller pick the mesh resolution for the next frame
+    if (paramManager->isAdaptiveResolutionEnabled()) {
+        resolutionController->update(frameDuration, lastWorkTime);
+        meshGenerator->setResolutionLimit(resolutionController->getResolution());
+    }
 }
 
 //--------------------------------------------------------------
@@ -191,14 +245,6 @@ void ofApp::draw() {
     float xLfoAmp = ofGetWidth() * 0.25f * paramManager->getXLfoAmp() + keyControls.xLfoAmp;
     float yLfoAmp = ofGetHeight() * 0.25f * paramManager->getYLfoAmp() + keyControls.yLfoAmp;
     
-    // Update camera FBO if needed
-    if (camera.isInitialized() && camera.isFrameNew()) {
-        cameraFbo.begin();
-        ofClear(0, 0, 0, 255);
-        camera.draw(0, 0, width, height);
-        cameraFbo.end();
-    }
-    
     // Now render the effect in the main FBO
     mainFbo.begin();
     
@@ -212,10 +258,13 @@ void ofApp::draw() {
     shaderDisplace.begin();
     
     // Bind textures with explicit texture units
-    shaderDisplace.setUniformTexture("tex0", cameraFbo.getTexture(), 0);
-    shaderDisplace.setUniformTexture("x_noise_image", xNoiseImage.getTexture(), 1);
-    shaderDisplace.setUniformTexture("y_noise_image", yNoiseImage.getTexture(), 2);
-    shaderDisplace.setUniformTexture("z_noise_image", zNoiseImage.getTexture(), 3);
+    // Camera frames are sampled straight from the stream; raw YUYV frames
+    // are converted to RGB by the shader
+    bool cameraLive = isCameraOpen() && cameraStream.isAllocated();
+    shaderDisplace.setUniformTexture("tex0", cameraLive ? cameraStream.getTexture() : cameraFbo.getTexture(), 0);
+    shaderDisplace.setUniform1i("camera_yuyv", cameraLive && cameraYuyv ? 1 : 0);
+    shaderDisplace.setUniform1f("camera_texel_width", cameraStream.getWidth());
+    bindNoiseTextures();
     
     // Set luma key and other basic parameters
     shaderDisplace.setUniform1f("luma_key_level", lumaKeyLevel);
@@ -264,15 +313,15 @@ void ofApp::draw() {
     // Set line width for stroke
     glLineWidth(paramManager->getStrokeWeight());
     
+    // Let the mesh skip chunks the displacement can't bring on screen
+    meshGenerator->setDisplacementBounds(getDisplacementBounds(xDisplace, yDisplace, centerX, centerY,
+                                                               xLfoAmp, yLfoAmp, zLfoAmp));
+    
     // Draw the mesh
     ofPushMatrix();
     ofTranslate(0, 0, zoom);
     
-    if (paramManager->isWireframeEnabled()) {
-        meshGenerator->getMesh().drawWireframe();
-    } else {
-        meshGenerator->getMesh().draw();
-    }
+    meshGenerator->draw(shaderDisplace, paramManager->isWireframeEnabled());
     
     ofPopMatrix();
     
@@ -308,6 +357,7 @@ void ofApp::draw() {
     // Draw video device selection UI
     drawVideoDevicesUI();
     
+    lastWorkTime = (ofGetElapsedTimeMicros() - frameStartMicros) / 1000000.0f;
 }
 
 //--------------------------------------------------------------
@@ -346,6 +396,7 @@ void ofApp::exit() {
     }
     
     // Clean up resources
+    closeCamera();
     midiManager.reset();
 }
 
@@ -398,23 +449,60 @@ void ofApp::setupCamera(int w, int h) {
     // On Raspberry Pi, we need to set format BEFORE initializing grabber
     #ifdef TARGET_LINUX
     // First close any existing camera
-    if (camera.isInitialized()) {
-        camera.close();
+    closeCamera();
+    
+    // Stream straight from the driver when we can, skipping the grabber's
+    // own conversion and copy. YUYV is preferred since it goes to the GPU
+    // untouched; UYVY and NV12 are converted to RGBA on the CPU
+    uint32_t nativeFormat = V4L2_PIX_FMT_YUYV;
+    if (!devicePath.empty()) {
+        std::vector<V4L2Helper::VideoFormat> deviceFormats = V4L2Helper::listFormats(devicePath);
+        for (uint32_t candidate : {V4L2_PIX_FMT_YUYV, V4L2_PIX_FMT_UYVY, V4L2_PIX_FMT_NV12}) {
+            bool offered = std::any_of(deviceFormats.begin(), deviceFormats.end(),
+                                       [candidate](const V4L2Helper::VideoFormat& deviceFormat) {
+                                           return deviceFormat.pixelFormat == candidate;
+                                       });
+            if (offered) {
+                nativeFormat = candidate;
+                break;
+            }
+        }
     }
     
-    // Use v4l2-ctl directly to set the format (more reliable)
-    std::string v4l2Cmd = "v4l2-ctl -d " + devicePath +
-                           " --set-fmt-video=width=" + ofToString(desiredWidth) +
-                           ",height=" + ofToString(desiredHeight) +
-                           ",pixelformat=YUYV";
-                           
-    ofLogNotice("ofApp") << "Running: " << v4l2Cmd;
-    system(v4l2Cmd.c_str());
+    if (!devicePath.empty() &&
+        nativeCapture.open(devicePath, nativeFormat, desiredWidth, desiredHeight, frameRate)) {
+        nativePixelFormat = V4L2Helper::formatCodeToPixelFormat(nativeFormat);
+        cameraYuyv = nativeFormat == V4L2_PIX_FMT_YUYV;
+        
+        if (cameraYuyv) {
+            // Upload the frames untouched: each RGBA texel is one YUYV macropixel
+            // (Y0 U Y1 V), and nearest filtering keeps the shader's pick of Y0 or
+            // Y1 from blending into the neighbouring pair
+            cameraStream.allocate(nativeCapture.getWidth() / 2, nativeCapture.getHeight(), OF_PIXELS_RGBA);
+            cameraStream.getTexture().setTextureMinMagFilter(GL_NEAREST, GL_NEAREST);
+        } else {
+            cameraStream.allocate(nativeCapture.getWidth(), nativeCapture.getHeight(), OF_PIXELS_RGBA);
+        }
+        
+        ofLogNotice("ofApp") << "Native camera capture: "
+                           << V4L2Helper::formatCodeToFourCC(nativeFormat) << " "
+                           << nativeCapture.getWidth() << "x" << nativeCapture.getHeight()
+                           << " @ " << frameRate << "fps";
+        
+        paramManager->setVideoWidth(nativeCapture.getWidth());
+        paramManager->setVideoHeight(nativeCapture.getHeight());
+        
+        lastNativeSequence = -1;
+        captureThread.start([this](ofPixels& pixels) { return grabNativeFrame(pixels); });
+        return;
+    }
     
-    // Also set the framerate
-    v4l2Cmd = "v4l2-ctl -d " + devicePath + " --set-parm=" + ofToString(frameRate);
-    ofLogNotice("ofApp") << "Running: " << v4l2Cmd;
-    system(v4l2Cmd.c_str());
+    // Otherwise set the format through V4L2 before the grabber opens the device
+    if (!devicePath.empty()) {
+        ofLogNotice("ofApp") << "Native capture unavailable, falling back to ofVideoGrabber";
+        V4L2Helper::setFormat(devicePath, V4L2_PIX_FMT_YUYV, desiredWidth, desiredHeight);
+        V4L2Helper::setFrameRate(devicePath, frameRate);
+    }
     #endif
     
     // Now initialize openFrameworks grabber
@@ -450,6 +538,13 @@ void ofApp::setupCamera(int w, int h) {
     
     ofLogNotice("ofApp") << "Initializing camera with size: " << useWidth << "x" << useHeight;
     
+    // The grabber hands over RGB pixels
+    cameraYuyv = false;
+    
+    // Frames are streamed into cameraStream, so the grabber's own
+    // synchronous texture upload is turned off
+    camera.setUseTexture(false);
+    
     // Try to initialize camera
     bool initSuccess = false;
     
@@ -499,6 +594,8 @@ void ofApp::setupCamera(int w, int h) {
         paramManager->setVideoWidth(camera.getWidth());
         paramManager->setVideoHeight(camera.getHeight());
         
+        captureThread.start([this](ofPixels& pixels) { return grabCameraFrame(pixels); });
+        
         #ifdef TARGET_LINUX
         // Log the format we got
         if (!devicePath.empty()) {
@@ -512,21 +609,121 @@ void ofApp::setupCamera(int w, int h) {
 
 //--------------------------------------------------------------
 void ofApp::updateCamera() {
-    // Try to update camera if it's initialized
-    if (camera.isInitialized()) {
-        try {
-            camera.update();
-            
-            // Only draw new frame if available
-            if (camera.isFrameNew()) {
-                cameraFbo.begin();
-                ofClear(0, 0, 0, 255);
-                camera.draw(0, 0, width, height);
-                cameraFbo.end();
+    // Capture runs on its own thread; take the newest complete frame if one
+    // arrived since the last update, without waiting for the device
+    captureThread.update();
+    
+    // Each frame is uploaded exactly once, keyed by its sequence number, so
+    // an unchanged frame costs nothing. The upload goes through the stream's
+    // pixel buffers and overlaps with rendering
+    uint64_t sequence = captureThread.getFrameSequence();
+    cameraFrameNew = sequence != uploadedCameraSequence;
+    if (cameraFrameNew) {
+        cameraStream.loadData(captureThread.getFrame());
+        uploadedCameraSequence = sequence;
+    }
+    
+    updateCameraRates();
+}
+
+//--------------------------------------------------------------
+void ofApp::updateCameraRates() {
+    uint64_t now = ofGetElapsedTimeMillis();
+    uint64_t captured = captureThread.getCapturedFrames();
+    uint64_t uploads = cameraStream.getUploadCount();
+    
+    if (cameraRateStartMillis == 0) {
+        cameraRateStartMillis = now;
+        cameraRateCaptured = captured;
+        cameraRateUploads = uploads;
+        return;
+    }
+    
+    uint64_t elapsed = now - cameraRateStartMillis;
+    if (elapsed < 1000) return;
+    
+    cameraCaptureFps = (captured - cameraRateCaptured) * 1000.0f / elapsed;
+    cameraUploadFps = (uploads - cameraRateUploads) * 1000.0f / elapsed;
+    cameraRateStartMillis = now;
+    cameraRateCaptured = captured;
+    cameraRateUploads = uploads;
+}
+
+//--------------------------------------------------------------
+bool ofApp::grabNativeFrame(ofPixels& pixels) {
+    // Runs on the capture thread: wait for the newest frame the driver has,
+    // copy or convert it out of the mapped buffer and hand the buffer back
+    V4L2Capture::Frame frame;
+    if (!nativeCapture.grabFrame(frame, CAPTURE_TIMEOUT_MS)) {
+        return false;
+    }
+    
+    // Gaps in the driver's sequence numbers are frames that were never shown
+    if (lastNativeSequence >= 0 && frame.sequence > lastNativeSequence + 1) {
+        captureThread.addDroppedFrames(frame.sequence - lastNativeSequence - 1);
+    }
+    lastNativeSequence = frame.sequence;
+    
+    int captureWidth = nativeCapture.getWidth();
+    int captureHeight = nativeCapture.getHeight();
+    int bytesPerLine = nativeCapture.getBytesPerLine();
+    
+    // A short frame means the driver hit an error; skip it
+    bool complete = frame.bytesUsed >= PixelFormatConverter::getFrameSize(nativePixelFormat, bytesPerLine,
+                                                                          captureHeight);
+    if (complete) {
+        if (cameraYuyv) {
+            // Raw macropixels, one per RGBA texel, with any row padding dropped
+            size_t rowBytes = (size_t)captureWidth * 2;
+            pixels.allocate(captureWidth / 2, captureHeight, OF_PIXELS_RGBA);
+            for (int row = 0; row < captureHeight; row++) {
+                memcpy(pixels.getData() + row * rowBytes, frame.data + (size_t)row * bytesPerLine, rowBytes);
             }
-        } catch (const std::exception& e) {
-            ofLogError("ofApp") << "Exception during camera update: " << e.what();
+        } else {
+            pixels.allocate(captureWidth, captureHeight, OF_PIXELS_RGBA);
+            PixelFormatConverter::toRgba(nativePixelFormat, frame.data, bytesPerLine,
+                                         pixels.getData(), captureWidth, captureHeight);
+        }
+    }
+    
+    nativeCapture.releaseFrame(frame);
+    return complete;
+}
+
+//--------------------------------------------------------------
+bool ofApp::grabCameraFrame(ofPixels& pixels) {
+    // Runs on the capture thread; the grabber has no texture, so nothing
+    // here touches GL
+    try {
+        camera.update();
+        if (camera.isFrameNew()) {
+            pixels = camera.getPixels();
+            return true;
         }
+    } catch (const std::exception& e) {
+        ofLogError("ofApp") << "Exception during camera update: " << e.what();
+    }
+    
+    // Nothing new yet, check again shortly
+    std::this_thread::sleep_for(std::chrono::milliseconds(CAPTURE_POLL_MS));
+    return false;
+}
+
+//--------------------------------------------------------------
+bool ofApp::isCameraOpen() const {
+    return nativeCapture.isOpen() || camera.isInitialized();
+}
+
+//--------------------------------------------------------------
+void ofApp::closeCamera() {
+    // Stop capturing before the devices go away under the thread; the
+    // sequence numbers and counters start over with the next capture
+    captureThread.stop();
+    uploadedCameraSequence = 0;
+    cameraRateStartMillis = 0;
+    nativeCapture.close();
+    if (camera.isInitialized()) {
+        camera.close();
     }
 }
 
@@ -578,43 +775,200 @@ void ofApp::allocateFbos() {
 }
 
 //--------------------------------------------------------------
-ofImage ofApp::generatePerlinNoise(float theta, float resolution, ofImage& noiseImage) {
-    // Get performance mode setting
-    bool performanceMode = paramManager->isPerformanceModeEnabled();
+NoiseGenerator::Field ofApp::getNoiseField(float theta, float resolution, int channel, LfoShape shape) {
+    // Scale parameters; a coarse lattice steps further per sample
+    resolution *= 0.05f * noiseLatticeScale;
+    theta *= 0.1f;
     
-    // In performance mode, use higher skip values to process fewer pixels
-    int skip = performanceMode ? 4 : 2; // Process every 4th pixel in performance mode
+    // Every pixel is evaluated; the row kernel is cheap enough that blocks
+    // of repeated samples are no longer needed
+    ofPixels& pixels = noiseTexture.getPixels();
+    int channels = pixels.getNumChannels();
+    NoiseGenerator::Field field = {pixels.getData() + channel, (int)pixels.getWidth(), (int)pixels.getHeight(),
+                                   resolution, theta, channels};
+    
+    // The fractal shape sums octaves into the same channel
+    if (shape == LfoShape::Fractal) {
+        field.octaves = paramManager->getFbmOctaves();
+        field.lacunarity = paramManager->getFbmLacunarity();
+        field.gain = paramManager->getFbmGain();
+    }
+    return field;
+}
+
+//--------------------------------------------------------------
+void ofApp::startNoiseFields() {
+    // Only fields whose inputs moved are queued; with an LFO rate of zero
+    // a field stays a cache hit and costs nothing
+    NoiseGenerator::Field fields[3];
+    size_t count = 0;
+    
+    fields[count] = getNoiseField(xLfoArg, paramManager->getXFrequency(), 0, paramManager->getXLfoShape());
+    if (isNoiseFieldStale(xNoiseCache, fields[count])) count++;
+    fields[count] = getNoiseField(yLfoArg, paramManager->getYFrequency(), 1, paramManager->getYLfoShape());
+    if (isNoiseFieldStale(yNoiseCache, fields[count])) count++;
+    fields[count] = getNoiseField(zLfoArg, paramManager->getZFrequency(), 2, paramManager->getZLfoShape());
+    if (isNoiseFieldStale(zNoiseCache, fields[count])) count++;
+    
+    noiseGenerator->start(fields, count);
+}
+
+//--------------------------------------------------------------
+bool ofApp::isNoiseFieldStale(NoiseFieldCache& cache, const NoiseGenerator::Field& field) {
+    NoiseGenerator::FieldKey key = NoiseGenerator::getKey(field);
+    if (cache.valid && key == cache.key) {
+        cache.hits++;
+        return false;
+    }
     
-    // Scale parameters
-    resolution *= 0.05f;
-    theta *= 0.1f;
+    cache.key = key;
+    cache.valid = true;
+    cache.pending = true;
+    cache.misses++;
+    return true;
+}
+
+//--------------------------------------------------------------
+void ofApp::uploadNoiseFields() {
+    // One upload covers all three fields, skipped when none was regenerated
+    if (xNoiseCache.pending || yNoiseCache.pending || zNoiseCache.pending) {
+        noiseTexture.update();
+    }
+    xNoiseCache.pending = false;
+    yNoiseCache.pending = false;
+    zNoiseCache.pending = false;
+    
+    // The pool writes straight into these pixels, so anything that swaps
+    // the storage out from under it has to be caught
+    if (!noiseReallocationLogged && getNoiseReallocations() > 0) {
+        noiseReallocationLogged = true;
+        ofLogWarning("ofApp") << "Noise texture was reallocated after setup";
+    }
+}
+
+//--------------------------------------------------------------
+uint64_t ofApp::getNoiseReallocations() const {
+    return noiseTexture.getPixelReallocations() + noiseTexture.getTextureReallocations();
+}
+
+//--------------------------------------------------------------
+void ofApp::setupGpuNoise() {
+    if (!ofFbo::checkGLSupport()) {
+        ofLogWarning("ofApp") << "No render-to-texture support, noise stays on the CPU";
+        return;
+    }
     
-    // Get access to image pixels
-    ofPixels& pixels = noiseImage.getPixels();
-    int w = noiseImage.getWidth();
-    int h = noiseImage.getHeight();
+    bool loaded;
+    if (ofIsGLProgrammableRenderer()) {
+        loaded = shaderNoise.load("shadersGL3/noise");
+    } else {
+        #ifdef TARGET_OPENGLES
+            loaded = shaderNoise.load("shadersES2/noise");
+        #else
+            loaded = shaderNoise.load("shadersGL2/noise");
+        #endif
+    }
     
-    // Generate noise
-    for (int y = 0; y < h; y += skip) {
-        for (int x = 0; x < w; x += skip) {
-            int i = y * w + x;
-            float noiseValue = ofNoise(x * resolution, y * resolution, theta);
-            
-            // Fill a block of pixels with the same value for performance
-            for (int dy = 0; dy < skip && y + dy < h; dy++) {
-                for (int dx = 0; dx < skip && x + dx < w; dx++) {
-                    int idx = (y + dy) * w + (x + dx);
-                    if (idx < pixels.size()) {
-                        pixels[idx] = 255 * noiseValue;
-                    }
-                }
-            }
-        }
+    if (!loaded) {
+        ofLogWarning("ofApp") << "Noise shader failed to load, noise stays on the CPU";
+        return;
     }
     
-    // Update the image with the new pixels
-    noiseImage.update();
-    return noiseImage;
+    // Same size as the CPU fields so both paths look alike
+    ofFboSettings noiseSettings;
+    noiseSettings.width = noiseTexture.getWidth();
+    noiseSettings.height = noiseTexture.getHeight();
+    noiseSettings.internalformat = GL_RGBA;
+    noiseSettings.useDepth = false;
+    noiseSettings.minFilter = GL_LINEAR;
+    noiseSettings.maxFilter = GL_LINEAR;
+    
+    noiseFbo.allocate(noiseSettings);
+    
+    gpuNoiseSupported = noiseFbo.isAllocated();
+    if (gpuNoiseSupported) {
+        ofLogNotice("ofApp") << "GPU noise available";
+    }
+}
+
+//--------------------------------------------------------------
+void ofApp::renderNoiseFields() {
+    noiseFbo.begin();
+    ofPushStyle();
+    ofFill();
+    shaderNoise.begin();
+    
+    // Same scaling as getNoiseField, one field per channel
+    shaderNoise.setUniform3f("theta", xLfoArg * 0.1f, yLfoArg * 0.1f, zLfoArg * 0.1f);
+    float scale = 0.05f * noiseLatticeScale;
+    shaderNoise.setUniform3f("resolution", paramManager->getXFrequency() * scale,
+                             paramManager->getYFrequency() * scale, paramManager->getZFrequency() * scale);
+    
+    // Octaves per channel, 1 unless that axis uses the fractal shape
+    float fbmOctaves = paramManager->getFbmOctaves();
+    shaderNoise.setUniform3f("octaves",
+                             paramManager->getXLfoShape() == LfoShape::Fractal ? fbmOctaves : 1.0f,
+                             paramManager->getYLfoShape() == LfoShape::Fractal ? fbmOctaves : 1.0f,
+                             paramManager->getZLfoShape() == LfoShape::Fractal ? fbmOctaves : 1.0f);
+    shaderNoise.setUniform1f("lacunarity", paramManager->getFbmLacunarity());
+    shaderNoise.setUniform1f("gain", paramManager->getFbmGain());
+    ofDrawRectangle(0, 0, noiseFbo.getWidth(), noiseFbo.getHeight());
+    
+    shaderNoise.end();
+    ofPopStyle();
+    noiseFbo.end();
+}
+
+//--------------------------------------------------------------
+NoiseMode ofApp::getActiveNoiseMode() const {
+    // Modes this renderer can't do fall back to the CPU fields
+    switch (paramManager->getNoiseMode()) {
+        case NoiseMode::Shader:
+            return gpuNoiseSupported ? NoiseMode::Shader : NoiseMode::Cpu;
+        case NoiseMode::Volume:
+            // The volume can't sum octaves, the shader and the CPU fields can
+            if (usesFractalShape()) {
+                return gpuNoiseSupported ? NoiseMode::Shader : NoiseMode::Cpu;
+            }
+            return noiseVolume.isAllocated() ? NoiseMode::Volume : NoiseMode::Cpu;
+        default:
+            return NoiseMode::Cpu;
+    }
+}
+
+//--------------------------------------------------------------
+bool ofApp::usesFractalShape() const {
+    return paramManager->getXLfoShape() == LfoShape::Fractal ||
+           paramManager->getYLfoShape() == LfoShape::Fractal ||
+           paramManager->getZLfoShape() == LfoShape::Fractal;
+}
+
+//--------------------------------------------------------------
+ofTexture& ofApp::getNoiseTexture() {
+    return getActiveNoiseMode() == NoiseMode::Shader ? noiseFbo.getTexture() : noiseTexture.getTexture();
+}
+
+//--------------------------------------------------------------
+void ofApp::bindNoiseTextures() {
+    // All three fields in one texture, one bind per frame
+    shaderDisplace.setUniformTexture("noise_image", getNoiseTexture(), 1);
+    
+    // The 3D sampler must never sit on unit 0 next to tex0, even unused
+    shaderDisplace.setUniform1i("noise_volume", 2);
+    
+    bool useVolume = getActiveNoiseMode() == NoiseMode::Volume;
+    shaderDisplace.setUniform1i("noise_volume_enabled", useVolume ? 1 : 0);
+    if (!useVolume) return;
+    
+    // Slices follow the LFO phase every frame, sized like the full-quality
+    // noise fields whatever lattice the CPU path uses
+    noiseVolume.bind(shaderDisplace, 2);
+    glm::vec3 xSlice = noiseVolume.getSlice(xLfoArg, paramManager->getXFrequency(), noiseFieldWidth, noiseFieldHeight);
+    glm::vec3 ySlice = noiseVolume.getSlice(yLfoArg, paramManager->getYFrequency(), noiseFieldWidth, noiseFieldHeight);
+    glm::vec3 zSlice = noiseVolume.getSlice(zLfoArg, paramManager->getZFrequency(), noiseFieldWidth, noiseFieldHeight);
+    shaderDisplace.setUniform3f("x_noise_slice", xSlice.x, xSlice.y, xSlice.z);
+    shaderDisplace.setUniform3f("y_noise_slice", ySlice.x, ySlice.y, ySlice.z);
+    shaderDisplace.setUniform3f("z_noise_slice", zSlice.x, zSlice.y, zSlice.z);
 }
 
 //--------------------------------------------------------------
@@ -812,6 +1166,56 @@ void ofApp::drawAudioVisualization() {
 
 }
 
+//--------------------------------------------------------------
+MeshGenerator::DisplacementBounds ofApp::getDisplacementBounds(float xDisplace, float yDisplace,
+                                                               float centerX, float centerY,
+                                                               float xLfoAmp, float yLfoAmp, float zLfoAmp) const {
+    // Follows the oscillator chain in displacement.vert, every oscillator
+    // output is within [-1, 1] and brightness within [0, 2 log 2]
+    float maxBright = 2.0f * log(2.0f);
+    float xAmp = fabs(xLfoAmp);
+    float yAmp = fabs(yLfoAmp);
+    
+    float firstYLfo = yAmp + (paramManager->isYRingModEnabled() ? 0.01f * xAmp : 0.0f);
+    float zLfo = fabs(zLfoAmp) + (paramManager->isZRingModEnabled() ? 0.0025f * firstYLfo : 0.0f);
+    float secondXLfo = xAmp + (paramManager->isXRingModEnabled() ? 1000.0f * zLfo : 0.0f);
+    float secondYLfo = yAmp + (paramManager->isYRingModEnabled() ? secondXLfo : 0.0f);
+    
+    MeshGenerator::DisplacementBounds bounds;
+    bounds.offsetX = centerX;
+    bounds.offsetY = centerY;
+    bounds.minScale = 1.0f - zLfo;
+    bounds.maxScale = 1.0f + zLfo;
+    bounds.shiftX = fabs(xDisplace) * maxBright + secondXLfo;
+    bounds.shiftY = fabs(yDisplace) * maxBright + secondYLfo;
+    return bounds;
+}
+
+//--------------------------------------------------------------
+std::string ofApp::getRenderModeName(MeshRenderMode mode) const {
+    switch (mode) {
+        case MeshRenderMode::Procedural:
+            return "Procedural";
+        case MeshRenderMode::Instanced:
+            return "Instanced";
+        default:
+            return "Vertex buffer";
+    }
+}
+
+//--------------------------------------------------------------
+std::string ofApp::getNoiseModeName(NoiseMode mode) const {
+    switch (mode) {
+        case NoiseMode::Shader:
+            return "GPU shader";
+        case NoiseMode::Volume:
+            return "Baked volume";
+        default:
+            return "CPU " + std::string(NoiseGenerator::getKernelName()) + ", " +
+                   ofToString(noiseGenerator->getNumThreads()) + " workers";
+    }
+}
+
 //--------------------------------------------------------------
 void ofApp::drawDebugInfo() {
     if (!paramManager->isDebugEnabled()) {
@@ -888,11 +1292,65 @@ void ofApp::drawDebugInfo() {
         y += lineHeight;
     }
     
+    // Adaptive resolution state
+    if (paramManager->isAdaptiveResolutionEnabled()) {
+        ofDrawBitmapString("--- Adaptive Resolution ---", x, y);
+        y += lineHeight;
+        ofDrawBitmapString("Target: " + ofToString(paramManager->getTargetFrameRate()) + "fps ("
+                          + ofToString(resolutionController->getTargetFrameTime() * 1000, 1) + "ms)", x, y);
+        y += lineHeight;
+        ofDrawBitmapString("Frame: " + ofToString(resolutionController->getAverageFrameTime() * 1000, 1)
+                          + "ms work: " + ofToString(resolutionController->getAverageWorkTime() * 1000, 1) + "ms", x, y);
+        y += lineHeight;
+        ofDrawBitmapString("Resolution: " + ofToString(resolutionController->getResolution())
+                          + " (" + ofToString(paramManager->getMinScale()) + "-" + ofToString(paramManager->getScale()) + ")", x, y);
+        y += lineHeight;
+        for (const auto& decision : resolutionController->getHistory()) {
+            ofDrawBitmapString("  #" + ofToString(decision.frame) + ": " + ofToString(decision.fromScale)
+                              + " -> " + ofToString(decision.toScale) + " at "
+                              + ofToString(decision.frameTime * 1000, 1) + "ms", x, y);
+            y += lineHeight;
+        }
+    }
+    
     // Current mesh info
     ofDrawBitmapString("Mesh type: " + ofToString(static_cast<int>(paramManager->getMeshType())), x, y);
     y += lineHeight;
     ofDrawBitmapString("Resolution: " + ofToString(paramManager->getScale()), x, y);
     y += lineHeight;
+    ofDrawBitmapString("Render mode: " + getRenderModeName(meshGenerator->getActiveRenderMode()), x, y);
+    y += lineHeight;
+    ofDrawBitmapString("Noise: " + getNoiseModeName(getActiveNoiseMode()) + " (lattice " +
+                       ofToString(noiseTexture.getWidth()) + "x" + ofToString(noiseTexture.getHeight()) + ")", x, y);
+    y += lineHeight;
+    if (noiseVolumeFallback) {
+        ofDrawBitmapString("Noise volume off: no fractal octaves", x, y);
+        y += lineHeight;
+    }
+    // Procedural and instanced draws generate their vertices in the shader,
+    // so the uploaded mesh's indices and chunks don't apply to them
+    if (meshGenerator->getActiveRenderMode() == MeshRenderMode::VertexBuffer) {
+        ofDrawBitmapString("Mesh vertices: " + ofToString(meshGenerator->getNumVertices())
+                          + " indices: " + ofToString(meshGenerator->getNumIndices()), x, y);
+        y += lineHeight;
+        ofDrawBitmapString("Mesh chunks: " + ofToString(meshGenerator->getDrawnChunks()) + "/"
+                          + ofToString(meshGenerator->getNumChunks()) + " drawn", x, y);
+    } else {
+        ofDrawBitmapString("Mesh vertices: " + ofToString(meshGenerator->getNumDrawnVertices())
+                          + " per draw, indices: N/A", x, y);
+        y += lineHeight;
+        ofDrawBitmapString("Mesh chunks: N/A", x, y);
+    }
+    y += lineHeight;
+    ofDrawBitmapString("Mesh cache: " + ofToString(meshGenerator->getCacheSize()) + " meshes, "
+                      + ofToString(meshGenerator->getCacheBytes() / (1024.0f * 1024.0f), 1) + "/"
+                      + ofToString(paramManager->getMeshCacheSize()) + "MB", x, y);
+    y += lineHeight;
+    ofDrawBitmapString("Cache hits: " + ofToString(meshGenerator->getCacheHits())
+                      + " misses: " + ofToString(meshGenerator->getCacheMisses()), x, y);
+    y += lineHeight;
+    ofDrawBitmapString("Mesh rebuilds/s: " + ofToString(meshGenerator->getRebuildsPerSecond()), x, y);
+    y += lineHeight;
     
     // Parameter values
     ofDrawBitmapString("--- Parameters ---", x, y);
@@ -932,16 +1390,22 @@ void ofApp::drawDebugInfo() {
     y += lineHeight;
     
     // Basic texture info
-    ofDrawBitmapString("Camera texture: " + std::string(camera.isInitialized() ? "OK" : "Not initialized"), x, y);
+    ofDrawBitmapString("Camera texture: " + std::string(cameraStream.isAllocated() ? "OK" : "Not initialized"), x, y);
+    y += lineHeight;
+    
+    ofDrawBitmapString("XYZ Noise texture: " + std::string(noiseTexture.isAllocated() ? "OK" : "Not allocated"), x, y);
     y += lineHeight;
     
-    ofDrawBitmapString("X Noise texture: " + std::string(xNoiseImage.isAllocated() ? "OK" : "Not allocated"), x, y);
+    ofDrawBitmapString("Noise uploads: " + ofToString(noiseTexture.getUploadCount()) +
+                       " (reallocations: " + ofToString(getNoiseReallocations()) + ")", x, y);
     y += lineHeight;
     
-    ofDrawBitmapString("Y Noise texture: " + std::string(yNoiseImage.isAllocated() ? "OK" : "Not allocated"), x, y);
+    ofDrawBitmapString("Noise cache X/Y/Z hits: " + ofToString(xNoiseCache.hits) + "/" + ofToString(yNoiseCache.hits) +
+                       "/" + ofToString(zNoiseCache.hits), x, y);
     y += lineHeight;
     
-    ofDrawBitmapString("Z Noise texture: " + std::string(zNoiseImage.isAllocated() ? "OK" : "Not allocated"), x, y);
+    ofDrawBitmapString("Noise cache X/Y/Z misses: " + ofToString(xNoiseCache.misses) + "/" + ofToString(yNoiseCache.misses) +
+                       "/" + ofToString(zNoiseCache.misses), x, y);
     y += lineHeight;
     
     // FBO format info
@@ -969,9 +1433,16 @@ void ofApp::drawDebugInfo() {
     y += lineHeight;
 
     // Check if camera is initialized and working
-    ofDrawBitmapString("Camera initialized: " + std::string(camera.isInitialized() ? "YES" : "NO"), x, y);
+    ofDrawBitmapString("Camera initialized: " + std::string(isCameraOpen() ? "YES" : "NO"), x, y);
     y += lineHeight;
-    ofDrawBitmapString("Last frame new: " + std::string(camera.isFrameNew() ? "YES" : "NO"), x, y);
+    ofDrawBitmapString("Last frame new: " + std::string(cameraFrameNew ? "YES" : "NO"), x, y);
+    y += lineHeight;
+    ofDrawBitmapString("Camera frames: " + ofToString(captureThread.getCapturedFrames()) +
+                       " (dropped " + ofToString(captureThread.getDroppedFrames()) +
+                       ", duplicated " + ofToString(captureThread.getDuplicatedFrames()) + ")", x, y);
+    y += lineHeight;
+    ofDrawBitmapString("Camera rate: " + ofToString(cameraCaptureFps, 1) + " fps captured, " +
+                       ofToString(cameraUploadFps, 1) + " fps uploaded", x, y);
     y += lineHeight;
     
     // MIDI info on the right side
@@ -1143,7 +1614,6 @@ void ofApp::keyPressed(int key) {
                 // Normal ] increases scale
                 int scale = paramManager->getScale() + 1;
                 paramManager->setScale(scale);
-                meshGenerator->updateMeshFromParameters();
             }
             break;
             
@@ -1157,7 +1627,6 @@ void ofApp::keyPressed(int key) {
                 int scale = paramManager->getScale() - 1;
                 if (scale < 1) scale = 1;
                 paramManager->setScale(scale);
-                meshGenerator->updateMeshFromParameters();
             }
             break;
         
@@ -1170,28 +1639,26 @@ void ofApp::keyPressed(int key) {
         // LFO shapes
         case '6': {
             int shape = static_cast<int>(paramManager->getZLfoShape()) + 1;
-            paramManager->setZLfoShape(static_cast<LfoShape>(shape % 4));
+            paramManager->setZLfoShape(static_cast<LfoShape>(shape % 5));
             break;
         }
         case '7': {
             int shape = static_cast<int>(paramManager->getXLfoShape()) + 1;
-            paramManager->setXLfoShape(static_cast<LfoShape>(shape % 4));
+            paramManager->setXLfoShape(static_cast<LfoShape>(shape % 5));
             break;
         }
         case '8': {
             int shape = static_cast<int>(paramManager->getYLfoShape()) + 1;
-            paramManager->setYLfoShape(static_cast<LfoShape>(shape % 4));
+            paramManager->setYLfoShape(static_cast<LfoShape>(shape % 5));
             break;
         }
         
         // Mesh types
         case '9':
             paramManager->setMeshType(MeshType::VerticalLines);
-            meshGenerator->updateMeshFromParameters();
             break;
         case '0':
             paramManager->setMeshType(MeshType::HorizontalLines);
-            meshGenerator->updateMeshFromParameters();
             break;
         
         // Minus key - Handles multiple combinations
@@ -1203,8 +1670,8 @@ void ofApp::keyPressed(int key) {
                 paramManager->setVideoFrameRate(fps);
                 
                 // Reinitialize camera to apply - only if camera is initialized
-                if (camera.isInitialized()) {
-                    camera.close();
+                if (isCameraOpen()) {
+                    closeCamera();
                     setupCamera(width, height);
                 }
                 
@@ -1219,7 +1686,6 @@ void ofApp::keyPressed(int key) {
                 // Regular mesh control
                 paramManager->setMeshType(MeshType::TriangleGrid);
                 paramManager->setWireframeEnabled(false);
-                meshGenerator->updateMeshFromParameters();
             }
             break;
             
@@ -1232,8 +1698,8 @@ void ofApp::keyPressed(int key) {
                 paramManager->setVideoFrameRate(fps);
                 
                 // Reinitialize camera to apply - only if camera is initialized
-                if (camera.isInitialized()) {
-                    camera.close();
+                if (isCameraOpen()) {
+                    closeCamera();
                     setupCamera(width, height);
                 }
                 
@@ -1248,7 +1714,6 @@ void ofApp::keyPressed(int key) {
                 // Regular mesh control
                 paramManager->setMeshType(MeshType::TriangleGrid);
                 paramManager->setWireframeEnabled(true);
-                meshGenerator->updateMeshFromParameters();
             }
             break;
         
@@ -1273,8 +1738,10 @@ void ofApp::keyPressed(int key) {
                 
                 if (performanceMode) {
                     // Apply performance optimizations immediately
-                    // Reduce target framerate
-                    ofSetFrameRate(24);
+                    // Reduce target framerate, unless adaptive resolution is holding its own
+                    if (!paramManager->isAdaptiveResolutionEnabled()) {
+                        ofSetFrameRate(24);
+                    }
                     
                     // Force mesh update with performance scale
                     int currentScale = paramManager->getScale();
@@ -1283,9 +1750,8 @@ void ofApp::keyPressed(int key) {
                     // Only reduce scale if current scale is larger than performance scale
                     if (currentScale > performanceScale) {
                         paramManager->setScale(performanceScale);
-                        meshGenerator->updateMeshFromParameters();
                     }
-                } else {
+                } else if (!paramManager->isAdaptiveResolutionEnabled()) {
                     // Restore normal settings
                     ofSetFrameRate(30);
                 }
@@ -1303,6 +1769,31 @@ void ofApp::keyPressed(int key) {
             }
             break;
             
+        // Mesh render mode cycling
+        case 'G':
+            if (ofGetKeyPressed(OF_KEY_SHIFT)) {
+                if (!meshGenerator->isProceduralSupported()) {
+                    ofLogWarning("ofApp") << "Procedural and instanced grids require the GL3 renderer";
+                    break;
+                }
+                
+                MeshRenderMode mode = static_cast<MeshRenderMode>(
+                    (static_cast<int>(paramManager->getMeshRenderMode()) + 1) % 3);
+                paramManager->setMeshRenderMode(mode);
+                ofLogNotice("ofApp") << "Mesh render mode: " << getRenderModeName(mode);
+            }
+            break;
+            
+        // Noise mode cycling
+        case 'T':
+            if (ofGetKeyPressed(OF_KEY_SHIFT)) {
+                NoiseMode mode = static_cast<NoiseMode>(
+                    (static_cast<int>(paramManager->getNoiseMode()) + 1) % 3);
+                paramManager->setNoiseMode(mode);
+                ofLogNotice("ofApp") << "Noise mode: " << getNoiseModeName(mode);
+            }
+            break;
+            
         // Midi Mapping
         case 'M':
             if (ofGetKeyPressed(OF_KEY_SHIFT)) {
@@ -1565,9 +2056,7 @@ bool ofApp::selectVideoDevice(int deviceIndex) {
     }
     
     // Close current camera
-    if (camera.isInitialized()) {
-        camera.close();
-    }
+    closeCamera();
     
     // Set new device info
     std::string devicePath = videoDevices[deviceIndex].path;
@@ -1635,7 +2124,7 @@ bool ofApp::setVideoFormat(const std::string& format, int width, int height) {
                            << width << "x" << height;
         
         // Reinitialize camera
-        camera.close();
+        closeCamera();
         setupCamera(width, height);
         
         return true;
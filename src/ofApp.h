@@ -5,11 +5,17 @@
 #include "MidiManager.h"
 #include "ParameterManager.h"
 #include "MeshGenerator.h"
+#include "ResolutionController.h"
+#include "NoiseGenerator.h"
+#include "NoiseVolume.h"
+#include "TextureHelper.h"
 #include "ShaderLoader.h"
 #include "ofxXmlSettings.h"
 #include "AudioReactivityManager.h"
 #include "ofxFft.h"
 #include "V4L2Helper.h"
+#include "PixelFormatConverter.h"
+#include "CaptureThread.h"
 
 class ofApp : public ofBaseApp {
     
@@ -26,6 +32,13 @@ public:
     // Camera handling
     void setupCamera(int width, int height);
     void updateCamera();
+    void updateCameraRates();
+    bool isCameraOpen() const;
+    void closeCamera();
+    
+    // Grab functions for the capture thread
+    bool grabNativeFrame(ofPixels& pixels);
+    bool grabCameraFrame(ofPixels& pixels);
     
     // New video device functions
     void listVideoDevices();
@@ -37,12 +50,36 @@ public:
     
     // FBO management
     void allocateFbos();
-    ofFbo cameraFbo;  // For converting camera input to RGBA
+    ofFbo cameraFbo;  // Fallback image shown when no camera is open
     
     // Noise generation
-    ofImage generatePerlinNoise(float theta, float resolution, ofImage& noiseImage);
+    NoiseGenerator::Field getNoiseField(float theta, float resolution, int channel, LfoShape shape);
+    void startNoiseFields();
+    
+    // Inputs of the pixels a noise texture holds (or is being filled with)
+    struct NoiseFieldCache {
+        NoiseGenerator::FieldKey key;
+        bool valid = false;
+        bool pending = false;   // Regenerated, waiting for upload
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+    bool isNoiseFieldStale(NoiseFieldCache& cache, const NoiseGenerator::Field& field);
+    void setupGpuNoise();
+    void renderNoiseFields();
+    NoiseMode getActiveNoiseMode() const;
+    bool usesFractalShape() const;
+    void uploadNoiseFields();
+    uint64_t getNoiseReallocations() const;
+    ofTexture& getNoiseTexture();
+    void bindNoiseTextures();
 private:
     void drawDebugInfo();
+    std::string getRenderModeName(MeshRenderMode mode) const;
+    std::string getNoiseModeName(NoiseMode mode) const;
+    MeshGenerator::DisplacementBounds getDisplacementBounds(float xDisplace, float yDisplace,
+                                                            float centerX, float centerY,
+                                                            float xLfoAmp, float yLfoAmp, float zLfoAmp) const;
     
     // Configuration
     int width = 640;
@@ -52,9 +89,28 @@ private:
     std::unique_ptr<MidiManager> midiManager;
     std::unique_ptr<ParameterManager> paramManager;
     std::unique_ptr<MeshGenerator> meshGenerator;
+    std::unique_ptr<ResolutionController> resolutionController;
     
     // Camera input
     ofVideoGrabber camera;
+    V4L2Capture nativeCapture;   // Direct mmap capture, used instead of the grabber when it opens
+    ofPixelFormat nativePixelFormat = OF_PIXELS_UNKNOWN;  // Format native frames arrive in
+    bool cameraYuyv = false;     // cameraStream holds raw YUYV, converted in the shader
+    bool cameraFrameNew = false; // A frame was uploaded this update
+    CaptureThread captureThread; // Runs the capture so the render loop never waits on it
+    uint64_t uploadedCameraSequence = 0;  // Sequence number of the frame in cameraStream
+    
+    // Capture and upload rates over the last second; equal when every
+    // captured frame is uploaded exactly once
+    uint64_t cameraRateStartMillis = 0;
+    uint64_t cameraRateCaptured = 0;
+    uint64_t cameraRateUploads = 0;
+    float cameraCaptureFps = 0.0f;
+    float cameraUploadFps = 0.0f;
+    int64_t lastNativeSequence = -1;  // Capture thread only, to spot driver drops
+    static constexpr int CAPTURE_TIMEOUT_MS = 100;  // Longest wait for a native frame
+    static constexpr int CAPTURE_POLL_MS = 2;       // Grabber polling interval
+    TextureStream cameraStream;  // Camera frames, uploaded through pixel buffers
     bool hdmiAspectRatioEnabled = false;
     
     // New video device data
@@ -71,10 +127,28 @@ private:
     // Shader
     ofShader shaderDisplace;
     
-    // Noise textures
-    ofImage xNoiseImage;
-    ofImage yNoiseImage;
-    ofImage zNoiseImage;
+    // Noise texture, allocated once and updated in place
+    TextureStream noiseTexture;     // X/Y/Z fields in R/G/B
+    int noiseFieldWidth = 90;       // Field size at full quality
+    int noiseFieldHeight = 60;
+    float noiseLatticeScale = 1.0f; // Field texels per lattice sample, on both axes
+    NoiseFieldCache xNoiseCache;
+    NoiseFieldCache yNoiseCache;
+    NoiseFieldCache zNoiseCache;
+    bool noiseReallocationLogged = false;
+    
+    // Fills the noise texture pixels in the background; declared after the
+    // texture so it is destroyed (and waits for its workers) first
+    std::unique_ptr<NoiseGenerator> noiseGenerator;
+    
+    // GPU noise path: a shader renders the fields straight into a texture
+    ofShader shaderNoise;
+    ofFbo noiseFbo;
+    bool gpuNoiseSupported = false;
+    
+    // Baked noise volume path, baked in the background at startup
+    NoiseVolume noiseVolume;
+    bool noiseVolumeFallback = false;   // Fractal axes keep the volume off
     
     // LFO state
     float xLfoArg = 0.0f;
@@ -104,6 +178,8 @@ private:
     
     float performanceMetrics[60]; // Store last 60 frame times
     int metricIndex = 0;
+    uint64_t frameStartMicros = 0; // Start of the current update
+    float lastWorkTime = 0.0f;     // Time spent in the last update and draw
     
     std::unique_ptr<AudioReactivityManager> audioManager;
     void drawAudioVisualization();
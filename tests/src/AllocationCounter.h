@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @class AllocationCounter
+ * @brief Counts heap allocations made through operator new
+ *
+ * Replaces the global operator new of the test executable, never the
+ * app's, so a test can confirm a steady-state code path doesn't touch the
+ * heap. Every thread is counted, the noise pool's workers included, so
+ * nothing unrelated should run while counting.
+ */
+class AllocationCounter {
+public:
+    /**
+     * Reset the count and start counting
+     */
+    static void start();
+    
+    /**
+     * Stop counting
+     * @return Allocations made since start()
+     */
+    static uint64_t stop();
+};
@@ -0,0 +1,45 @@
+#include "TestRunner.h"
+#include "AllocationCounter.h"
+#include "NoiseGenerator.h"
+#include "TextureHelper.h"
+
+// Steady-state noise updates must not touch the heap: regenerate and upload
+// the three fields the way ofApp does every frame and count each allocation
+void runAllocationTests() {
+    const int width = 90;
+    const int height = 60;
+    const int rounds = 60;
+    
+    NoiseGenerator generator;
+    generator.setup();
+    
+    // X/Y/Z fields interleaved in one RGBA texture, one of them fractal
+    TextureStream stream;
+    stream.allocate(width, height, OF_PIXELS_RGBA);
+    unsigned char* pixels = stream.getPixels().getData();
+    NoiseGenerator::Field fields[3];
+    for (int channel = 0; channel < 3; channel++) {
+        fields[channel] = {pixels + channel, width, height, 0.05f, 0.0f, 4};
+    }
+    fields[2].octaves = 4;
+    
+    // Round -1 warms up anything allocated lazily on first use
+    for (int round = -1; round < rounds; round++) {
+        if (round == 0) {
+            AllocationCounter::start();
+        }
+        for (int channel = 0; channel < 3; channel++) {
+            fields[channel].z = round * 0.01f + channel;
+        }
+        generator.start(fields, 3);
+        generator.wait();
+        stream.update();
+    }
+    uint64_t allocations = AllocationCounter::stop();
+    
+    TestRunner::check(allocations == 0, ofToString(allocations) + " heap allocations over " +
+                      ofToString(rounds) + " noise updates (NoiseGenerator::start/wait, TextureStream::update)");
+    TestRunner::check(stream.getPixelReallocations() == 0 && stream.getTextureReallocations() == 0,
+                      "noise texture kept its pixels and texture across updates");
+    TestRunner::check(stream.getUploadCount() == rounds + 1, "every noise update uploaded once");
+}
@@ -0,0 +1,264 @@
+#include "TestRunner.h"
+#include "MeshGenerator.h"
+
+namespace {
+
+// The app's default canvas
+const int WIDTH = 640;
+const int HEIGHT = 480;
+const int RESOLUTIONS[] = {50, 100, 200, 500, 1000};
+
+struct NamedMeshType {
+    MeshType type;
+    const char* name;
+};
+
+const NamedMeshType MESH_TYPES[] = {
+    {MeshType::TriangleGrid, "Triangles"},
+    {MeshType::HorizontalLines, "Horizontal lines"},
+    {MeshType::VerticalLines, "Vertical lines"},
+    {MeshType::TriangleWireframe, "Wireframe"}
+};
+
+struct MeshCounts {
+    size_t vertices = 0;
+    size_t indices = 0;
+    size_t chunks = 0;
+};
+
+MeshCounts countMesh(const MeshGenerator::ChunkedMesh& mesh) {
+    MeshCounts counts;
+    for (const MeshGenerator::MeshChunk& chunk : mesh) {
+        counts.vertices += chunk.mesh.getNumVertices();
+        counts.indices += chunk.mesh.getNumIndices();
+    }
+    counts.chunks = mesh.size();
+    return counts;
+}
+
+// Every chunk must fit 16-bit indices and index only its own vertices (or
+// restart), and the chunk bounds must tile the whole canvas
+void testChunksAreValid() {
+    for (const NamedMeshType& meshType : MESH_TYPES) {
+        int meshes = 0;
+        int failures = 0;
+        for (int resolution : RESOLUTIONS) {
+            for (int variant = 0; variant < 4; variant++) {
+                bool performanceMode = variant & 1;
+                bool primitiveRestart = variant & 2;
+                MeshGenerator::MeshKey key = {meshType.type, resolution, WIDTH, HEIGHT,
+                                              performanceMode, primitiveRestart};
+                MeshGenerator::ChunkedMesh mesh;
+                MeshGenerator::generateMesh(key, mesh);
+                
+                bool valid = true;
+                float area = 0;
+                for (const MeshGenerator::MeshChunk& chunk : mesh) {
+                    size_t vertices = chunk.mesh.getNumVertices();
+                    valid = valid && vertices <= 65536 && chunk.mesh.getNumTexCoords() == vertices;
+                    for (ofIndexType index : chunk.mesh.getIndices()) {
+                        bool restart = primitiveRestart && index == std::numeric_limits<ofIndexType>::max();
+                        valid = valid && (index < vertices || restart);
+                    }
+                    area += chunk.bounds.getArea();
+                }
+                valid = valid && std::abs(area - WIDTH * HEIGHT) < 1.0f;
+                
+                meshes++;
+                if (!valid) {
+                    failures++;
+                    ofLogError("MeshGenerator") << meshType.name << " @ " << resolution
+                                                << (performanceMode ? ", performance mode" : "")
+                                                << (primitiveRestart ? ", primitive restart" : "")
+                                                << " has an invalid chunk";
+                }
+            }
+        }
+        
+        TestRunner::check(failures == 0, std::string(meshType.name) + ": chunks fit 16-bit indices, index only " +
+                          "their own vertices and cover the canvas (" + ofToString(failures) + " of " +
+                          ofToString(meshes) + " meshes fail)");
+    }
+}
+
+// The triangle grid shares one vertex per grid point: (r + 1)^2 vertices
+// and two triangles per cell while the grid fits one chunk
+void testTriangleGridIsIndexed() {
+    for (int resolution : RESOLUTIONS) {
+        if (resolution > MeshGenerator::CHUNK_CELLS) continue;
+        MeshGenerator::MeshKey key = {MeshType::TriangleGrid, resolution, WIDTH, HEIGHT, false, false};
+        MeshGenerator::ChunkedMesh mesh;
+        MeshGenerator::generateMesh(key, mesh);
+        MeshCounts counts = countMesh(mesh);
+        
+        size_t points = (size_t)(resolution + 1) * (resolution + 1);
+        size_t cells = (size_t)resolution * resolution;
+        TestRunner::check(counts.vertices == points && counts.indices == cells * 6,
+                          "Triangles @ " + ofToString(resolution) + ": " + ofToString(counts.vertices) +
+                          " vertices and " + ofToString(counts.indices) + " indices, expected " +
+                          ofToString(points) + " and " + ofToString(cells * 6));
+    }
+}
+
+void benchmarkGeneration() {
+    const int runs = 3;
+    
+    for (const NamedMeshType& meshType : MESH_TYPES) {
+        for (int resolution : RESOLUTIONS) {
+            MeshGenerator::MeshKey key = {meshType.type, resolution, WIDTH, HEIGHT, false, true};
+            MeshGenerator::ChunkedMesh mesh;
+            uint64_t micros = TestRunner::timeBest(runs, [&] { MeshGenerator::generateMesh(key, mesh); });
+            MeshCounts counts = countMesh(mesh);
+            ofLogNotice("MeshGenerator") << meshType.name << " @ " << resolution << " (" << WIDTH << "x" << HEIGHT
+                                         << "): " << micros / 1000.0f << "ms, " << counts.vertices << " vertices, "
+                                         << counts.indices << " indices, " << counts.chunks << " chunks, best of "
+                                         << runs;
+        }
+    }
+}
+
+// The non-indexed grid the triangle mesh used to be: every index expanded
+// into its own vertex, six per cell
+void expandIndices(const ofMesh& indexed, ofVboMesh& target) {
+    target.clear();
+    target.setMode(OF_PRIMITIVE_TRIANGLES);
+    for (ofIndexType index : indexed.getIndices()) {
+        target.addVertex(indexed.getVertices()[index]);
+        target.addTexCoord(indexed.getTexCoords()[index]);
+    }
+}
+
+// Fragment stage that shows where each fragment came from in the grid, so
+// two draws only match when they cover the same triangles the same way
+#ifdef TARGET_OPENGLES
+const char* const COORDINATE_FRAGMENT =
+    "precision highp float;\n"
+    "varying vec2 texCoordVarying;\n"
+    "void main() { gl_FragColor = vec4(texCoordVarying, 0.0, 1.0); }\n";
+#else
+const char* const COORDINATE_FRAGMENT =
+    "OF_GLSL_SHADER_HEADER\n"
+    "in vec2 texCoordVarying;\n"
+    "out vec4 outputColor;\n"
+    "void main() { outputColor = vec4(texCoordVarying, 0.0, 1.0); }\n";
+#endif
+
+// The app's displacement vertex shader from bin/data, so the draws do the
+// per-vertex work the indexed grid is meant to save
+bool loadDisplacementShader(ofShader& shader) {
+#ifdef TARGET_OPENGLES
+    std::string path = "../../../bin/data/shadersES2/displacement.vert";
+#else
+    std::string path = "../../../bin/data/shadersGL3/displacement.vert";
+#endif
+    return shader.setupShaderFromFile(GL_VERTEX_SHADER, path) &&
+           shader.setupShaderFromSource(GL_FRAGMENT_SHADER, COORDINATE_FRAGMENT) &&
+           shader.bindDefaults() && shader.linkProgram();
+}
+
+// Draws `mesh` `draws` times with the grid displaced by Perlin LFOs
+void drawDisplaced(ofFbo& fbo, ofShader& shader, ofTexture& noise, ofVboMesh& mesh, int draws) {
+    fbo.begin();
+    ofClear(0, 0, 0, 255);
+    shader.begin();
+    shader.setUniformTexture("tex0", noise, 0);
+    shader.setUniformTexture("noise_image", noise, 1);
+    shader.setUniform1i("noise_volume", 2);
+    shader.setUniform1i("noise_atlas", 2);
+    shader.setUniform1i("width", WIDTH);
+    shader.setUniform1i("height", HEIGHT);
+    shader.setUniform1i("xLfoShape", 3);
+    shader.setUniform1i("yLfoShape", 3);
+    shader.setUniform1i("zLfoShape", 3);
+    shader.setUniform1f("x_lfo_amp", 0.1f);
+    shader.setUniform1f("y_lfo_amp", 0.1f);
+    shader.setUniform1f("z_lfo_amp", 0.1f);
+    for (int draw = 0; draw < draws; draw++) {
+        mesh.draw();
+    }
+    shader.end();
+    fbo.end();
+    glFinish();
+}
+
+// Before/after comparison for the indexed triangle grid: the shared-vertex
+// mesh must draw exactly what six vertices per cell drew, from (r + 1)^2
+// instead of 6r^2 vertices; --benchmark also times both draws
+void testIndexedGridDrawsLikeExpanded() {
+    ofShader shader;
+    if (!TestRunner::check(loadDisplacementShader(shader), "displacement shader loads with a coordinate fragment stage")) {
+        return;
+    }
+    
+    ofFbo fbo;
+    fbo.allocate(WIDTH, HEIGHT, GL_RGBA);
+    
+    // Deterministic noise for the displacement to read
+    ofPixels noisePixels;
+    noisePixels.allocate(90, 60, OF_PIXELS_RGBA);
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < noisePixels.size(); i++) {
+        seed = seed * 1664525 + 1013904223;
+        noisePixels[i] = seed >> 24;
+    }
+    ofTexture noise;
+    noise.loadData(noisePixels);
+    
+    const int draws = 10;
+    const int runs = 5;
+    
+    for (int resolution : RESOLUTIONS) {
+        if (resolution > MeshGenerator::CHUNK_CELLS) continue;
+        MeshGenerator::MeshKey key = {MeshType::TriangleGrid, resolution, WIDTH, HEIGHT, false, false};
+        MeshGenerator::ChunkedMesh mesh;
+        MeshGenerator::generateMesh(key, mesh);
+        ofVboMesh& indexed = mesh[0].mesh;
+        ofVboMesh expanded;
+        expandIndices(indexed, expanded);
+        
+        ofPixels indexedPixels;
+        ofPixels expandedPixels;
+        drawDisplaced(fbo, shader, noise, indexed, 1);
+        fbo.readToPixels(indexedPixels);
+        drawDisplaced(fbo, shader, noise, expanded, 1);
+        fbo.readToPixels(expandedPixels);
+        
+        int mismatches = 0;
+        for (size_t i = 0; i < indexedPixels.size(); i++) {
+            if (indexedPixels[i] != expandedPixels[i]) mismatches++;
+        }
+        TestRunner::check(mismatches == 0 && expanded.getNumVertices() == (size_t)resolution * resolution * 6,
+                          "Triangles @ " + ofToString(resolution) + ": " + ofToString(indexed.getNumVertices()) +
+                          " indexed vertices draw like " + ofToString(expanded.getNumVertices()) +
+                          " expanded ones (" + ofToString(mismatches) + " bytes differ)");
+        
+        if (TestRunner::isBenchmarking()) {
+            uint64_t expandedMicros = TestRunner::timeBest(runs, [&] {
+                drawDisplaced(fbo, shader, noise, expanded, draws);
+            });
+            uint64_t indexedMicros = TestRunner::timeBest(runs, [&] {
+                drawDisplaced(fbo, shader, noise, indexed, draws);
+            });
+            ofLogNotice("MeshGenerator") << "Triangles @ " << resolution << " draw: "
+                                         << expanded.getNumVertices() << " expanded vertices "
+                                         << expandedMicros / 1000.0f / draws << "ms, "
+                                         << indexed.getNumVertices() << " indexed vertices "
+                                         << indexedMicros / 1000.0f / draws << "ms, per draw, best of " << runs;
+        }
+    }
+}
+
+}
+
+void runMeshGeneratorTests() {
+    testChunksAreValid();
+    testTriangleGridIsIndexed();
+    
+    if (TestRunner::isBenchmarking()) {
+        benchmarkGeneration();
+    }
+}
+
+void runMeshGeneratorGlTests() {
+    testIndexedGridDrawsLikeExpanded();
+}
@@ -0,0 +1,300 @@
+#include "TestRunner.h"
+#include "NoiseGenerator.h"
+
+namespace {
+
+// The app's noise field sizes: performance mode, standard, and the old default
+const int SIZES[][2] = {{45, 30}, {90, 60}, {180, 120}};
+
+// The fill ofApp used before the row kernels: one ofNoise sample per
+// skip x skip block
+void fillPixelsBlocky(unsigned char* pixels, int w, int h, float step, float z, int skip) {
+    for (int y = 0; y < h; y += skip) {
+        for (int x = 0; x < w; x += skip) {
+            float noiseValue = ofNoise(x * step, y * step, z);
+            for (int dy = 0; dy < skip && y + dy < h; dy++) {
+                for (int dx = 0; dx < skip && x + dx < w; dx++) {
+                    pixels[(y + dy) * w + (x + dx)] = 255 * noiseValue;
+                }
+            }
+        }
+    }
+}
+
+// The row kernels replace a full-resolution ofNoise pass, so they must
+// give the same bytes, whichever kernel this CPU picked
+void testKernelMatchesOfNoise() {
+    const float steps[] = {0.005f, 0.05f, 0.2f};
+    const float zs[] = {0.0f, 1.7f, 35.2f};
+    
+    for (const auto& size : SIZES) {
+        int w = size[0];
+        int h = size[1];
+        std::vector<unsigned char> reference(w * h);
+        std::vector<unsigned char> pixels(w * h);
+        int mismatches = 0;
+        
+        for (float step : steps) {
+            for (float z : zs) {
+                fillPixelsBlocky(reference.data(), w, h, step, z, 1);
+                NoiseGenerator::fillPixels(pixels.data(), w, h, step, z);
+                for (int i = 0; i < w * h; i++) {
+                    if (pixels[i] != reference[i]) mismatches++;
+                }
+            }
+        }
+        
+        TestRunner::check(mismatches == 0, std::string(NoiseGenerator::getKernelName()) + " kernel " +
+                          ofToString(w) + "x" + ofToString(h) + " matches ofNoise (" +
+                          ofToString(mismatches) + " pixels differ)");
+    }
+}
+
+// fBm the slow way, one NoiseGenerator::noise call per pixel and octave,
+// summed in the same order as the row kernel path
+unsigned char fbmReference(const NoiseGenerator::Field& field, int x, int y) {
+    float totalAmplitude = 0;
+    float amplitude = 1;
+    for (int octave = 0; octave < field.octaves; octave++) {
+        totalAmplitude += amplitude;
+        amplitude *= field.gain;
+    }
+    
+    float value = 0;
+    float frequency = 1;
+    amplitude = 1;
+    for (int octave = 0; octave < field.octaves; octave++) {
+        float step = field.step * frequency;
+        float z = field.z * frequency + octave * NoiseGenerator::FBM_OCTAVE_OFFSET;
+        value += amplitude / totalAmplitude * NoiseGenerator::noise(x * step, y * step, z);
+        frequency *= field.lacunarity;
+        amplitude *= field.gain;
+    }
+    return 255 * value;
+}
+
+// Every octave is evaluated densely, so only float rounding (e.g. a fused
+// multiply-add on one side) may move a pixel, and by one level at most
+void testFbmMatchesReference() {
+    const float steps[] = {0.005f, 0.05f, 0.2f};
+    const int octaveCounts[] = {2, 4, NoiseGenerator::MAX_OCTAVES};
+    const float lacunarities[] = {2.0f, 2.7f};
+    const float gains[] = {0.5f, 0.8f};
+    
+    for (const auto& size : SIZES) {
+        int w = size[0];
+        int h = size[1];
+        std::vector<unsigned char> pixels(w * h);
+        int mismatches = 0;
+        int maxDifference = 0;
+        int fields = 0;
+        
+        for (float step : steps) {
+            for (int octaves : octaveCounts) {
+                for (float lacunarity : lacunarities) {
+                    for (float gain : gains) {
+                        NoiseGenerator::Field field = {pixels.data(), w, h, step, 1.7f};
+                        field.octaves = octaves;
+                        field.lacunarity = lacunarity;
+                        field.gain = gain;
+                        NoiseGenerator::fillPixels(field, 0, h);
+                        fields++;
+                        
+                        for (int y = 0; y < h; y++) {
+                            for (int x = 0; x < w; x++) {
+                                int difference = std::abs(pixels[y * w + x] - fbmReference(field, x, y));
+                                if (difference > 0) mismatches++;
+                                maxDifference = std::max(maxDifference, difference);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        
+        TestRunner::check(maxDifference <= 1, "fBm " + ofToString(w) + "x" + ofToString(h) + " over " +
+                          ofToString(fields) + " fields within 1 level of the per-pixel reference (" +
+                          ofToString(mismatches) + " pixels differ, by at most " + ofToString(maxDifference) + ")");
+    }
+}
+
+// The kernel against the old ofNoise fills, at every other pixel and at
+// every pixel
+void benchmarkKernel() {
+    const int runs = 20;
+    // Typical scaled frequency and LFO phase from generatePerlinNoise
+    const float step = 0.05f;
+    const float z = 1.7f;
+    
+    for (const auto& size : SIZES) {
+        int w = size[0];
+        int h = size[1];
+        std::vector<unsigned char> pixels(w * h);
+        
+        uint64_t blockyMicros = TestRunner::timeBest(runs, [&] { fillPixelsBlocky(pixels.data(), w, h, step, z, 2); });
+        uint64_t fullMicros = TestRunner::timeBest(runs, [&] { fillPixelsBlocky(pixels.data(), w, h, step, z, 1); });
+        uint64_t kernelMicros = TestRunner::timeBest(runs, [&] { NoiseGenerator::fillPixels(pixels.data(), w, h, step, z); });
+        ofLogNotice("NoiseGenerator") << w << "x" << h << ": ofNoise skip 2 " << blockyMicros / 1000.0f
+                                      << "ms, ofNoise skip 1 " << fullMicros / 1000.0f << "ms, "
+                                      << NoiseGenerator::getKernelName() << " kernel skip 1 "
+                                      << kernelMicros / 1000.0f << "ms, best of " << runs;
+    }
+}
+
+// Standard deviation of noise sampled on a size^3 grid spanning `period`
+// lattice cells per side
+template<typename Noise>
+float getSpread(int size, int period, Noise noise) {
+    double sum = 0;
+    double squares = 0;
+    float step = (float)period / size;
+    for (int z = 0; z < size; z++) {
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                float value = noise(x * step, y * step, z * step);
+                sum += value;
+                squares += value * value;
+            }
+        }
+    }
+    double count = (double)size * size * size;
+    double mean = sum / count;
+    return sqrt(squares / count - mean * mean);
+}
+
+// The baked volume stands in for ofNoise, so it must wrap seamlessly and
+// vary about as much
+void testTileableNoise() {
+    const int period = 8;
+    int seams = 0;
+    for (int i = 0; i < 1000; i++) {
+        // Multiples of 1/16 keep the shifted coordinates exact
+        float x = (i * 37 % 2048 - 1024) / 16.0f;
+        float y = (i % 97) / 16.0f;
+        float z = (i % 31) / 16.0f - 1.0f;
+        // Lattice points may round differently depending on which cell
+        // claims them, far below one 8-bit step
+        float value = NoiseGenerator::tileableNoise(x, y, z, period);
+        float shifted = NoiseGenerator::tileableNoise(x + period, y - period, z + 2 * period, period);
+        if (std::abs(shifted - value) > 1e-5f) seams++;
+    }
+    TestRunner::check(seams == 0, "tileable noise repeats every period (" + ofToString(seams) +
+                      " of 1000 points differ one period away)");
+    
+    float tileableSpread = getSpread(48, period, [&](float x, float y, float z) {
+        return NoiseGenerator::tileableNoise(x, y, z, period);
+    });
+    float noiseSpread = getSpread(48, period, [](float x, float y, float z) {
+        return NoiseGenerator::noise(x + 0.3f, y + 0.1f, z + 0.7f);
+    });
+    float ratio = tileableSpread / noiseSpread;
+    TestRunner::check(ratio > 0.9f && ratio < 1.1f, "tileable noise varies like ofNoise (standard deviation " +
+                      ofToString(tileableSpread, 3) + " against " + ofToString(noiseSpread, 3) + ")");
+}
+
+// The pool splits fields into bands of rows; the bands must add up to the
+// same pixels as filling each field in one go
+void testPoolMatchesSerial() {
+    NoiseGenerator generator;
+    generator.setup();
+    
+    for (const auto& size : SIZES) {
+        int w = size[0];
+        int h = size[1];
+        std::vector<unsigned char> serial[3];
+        std::vector<unsigned char> pooled[3];
+        NoiseGenerator::Field fields[3];
+        for (int f = 0; f < 3; f++) {
+            serial[f].resize(w * h);
+            pooled[f].resize(w * h);
+            fields[f] = {pooled[f].data(), w, h, 0.05f, 1.7f + f};
+        }
+        fields[2].octaves = 4;
+        
+        generator.start(fields, 3);
+        generator.wait();
+        
+        int mismatches = 0;
+        for (int f = 0; f < 3; f++) {
+            NoiseGenerator::Field field = fields[f];
+            field.pixels = serial[f].data();
+            NoiseGenerator::fillPixels(field, 0, h);
+            for (int i = 0; i < w * h; i++) {
+                if (pooled[f][i] != serial[f][i]) mismatches++;
+            }
+        }
+        
+        TestRunner::check(mismatches == 0, ofToString(generator.getNumThreads()) + " workers fill 3 " +
+                          ofToString(w) + "x" + ofToString(h) + " fields like a serial fill (" +
+                          ofToString(mismatches) + " pixels differ)");
+    }
+}
+
+// All three fields, as ofApp fills them each frame, one after another on
+// this thread and then through the pool
+void benchmarkPool() {
+    const int runs = 20;
+    NoiseGenerator generator;
+    generator.setup();
+    
+    for (const auto& size : SIZES) {
+        int w = size[0];
+        int h = size[1];
+        std::vector<unsigned char> pixels[3];
+        NoiseGenerator::Field fields[3];
+        for (int f = 0; f < 3; f++) {
+            pixels[f].resize(w * h);
+            fields[f] = {pixels[f].data(), w, h, 0.05f, 1.7f + f};
+        }
+        
+        uint64_t serialMicros = TestRunner::timeBest(runs, [&] {
+            for (const NoiseGenerator::Field& field : fields) {
+                NoiseGenerator::fillPixels(field, 0, h);
+            }
+        });
+        uint64_t pooledMicros = TestRunner::timeBest(runs, [&] {
+            generator.start(fields, 3);
+            generator.wait();
+        });
+        ofLogNotice("NoiseGenerator") << w << "x" << h << " x3 fields: serial " << serialMicros / 1000.0f
+                                      << "ms, pooled " << pooledMicros / 1000.0f << "ms, "
+                                      << generator.getNumThreads() << " workers, best of " << runs;
+    }
+}
+
+void benchmarkFbm() {
+    const int runs = 20;
+    // The app's default 4 octaves at a typical scaled frequency
+    const float step = 0.05f;
+    const int octaves = 4;
+    
+    for (const auto& size : SIZES) {
+        int w = size[0];
+        int h = size[1];
+        std::vector<unsigned char> pixels(w * h);
+        NoiseGenerator::Field singleOctave = {pixels.data(), w, h, step, 1.7f};
+        NoiseGenerator::Field fbm = singleOctave;
+        fbm.octaves = octaves;
+        
+        uint64_t singleMicros = TestRunner::timeBest(runs, [&] { NoiseGenerator::fillPixels(singleOctave, 0, h); });
+        uint64_t fbmMicros = TestRunner::timeBest(runs, [&] { NoiseGenerator::fillPixels(fbm, 0, h); });
+        ofLogNotice("NoiseGenerator") << w << "x" << h << ": 1 octave " << singleMicros / 1000.0f << "ms, fBm "
+                                      << octaves << " octaves " << fbmMicros / 1000.0f << "ms, "
+                                      << NoiseGenerator::getKernelName() << " kernel, best of " << runs;
+    }
+}
+
+}
+
+void runNoiseGeneratorTests() {
+    testKernelMatchesOfNoise();
+    testFbmMatchesReference();
+    testPoolMatchesSerial();
+    testTileableNoise();
+    
+    if (TestRunner::isBenchmarking()) {
+        benchmarkKernel();
+        benchmarkPool();
+        benchmarkFbm();
+    }
+}
@@ -0,0 +1,29 @@
+#include "TestRunner.h"
+#include "NoiseVolume.h"
+
+// The period is sized so a full quality field never shows the volume
+// repeating; the shader samples slices at texCoords * 0.5 * xy
+void runNoiseVolumeTests() {
+    NoiseVolume volume;
+    const float maxFrequency = 3.5f;
+    glm::vec3 slice = volume.getSlice(0.0f, maxFrequency, 90, 60);
+    float span = 0.5f * std::max(slice.x, slice.y);
+    TestRunner::check(span <= 1.0f, "a 90x60 field at frequency " + ofToString(maxFrequency) + " spans " +
+                      ofToString(span) + " volume periods");
+}
+
+// setup() must leave the bake to its worker, and update() must upload the
+// result once it is done
+void runNoiseVolumeGlTests() {
+    NoiseVolume volume;
+    volume.setup();
+    TestRunner::check(!volume.isAllocated(), "noise volume setup returns before the bake is uploaded");
+    
+    uint64_t start = ofGetElapsedTimeMillis();
+    while (!volume.isAllocated() && ofGetElapsedTimeMillis() - start < 10000) {
+        volume.update();
+        ofSleepMillis(1);
+    }
+    TestRunner::check(volume.isAllocated(), "noise volume uploaded after " +
+                      ofToString(ofGetElapsedTimeMillis() - start) + "ms of update() calls");
+}
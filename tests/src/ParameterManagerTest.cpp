@@ -0,0 +1,42 @@
+#include "TestRunner.h"
+#include "ParameterManager.h"
+#include "NoiseGenerator.h"
+
+namespace {
+
+// Out of range fBm settings from settings.xml or MIDI must never reach the
+// noise kernels, where a zero amplitude sum turns the weights into NaN
+void testFbmSettingsAreClamped() {
+    ParameterManager parameters;
+    const float badGains[] = {-1.0f, 0.0f, 2.0f, NAN, INFINITY};
+    const float badLacunarities[] = {-2.0f, 0.0f, 0.5f, 100.0f, NAN, INFINITY};
+    
+    bool gainsValid = true;
+    for (float gain : badGains) {
+        parameters.setFbmGain(gain);
+        float clamped = parameters.getFbmGain();
+        gainsValid = gainsValid && clamped > 0.0f && clamped <= 1.0f;
+    }
+    TestRunner::check(gainsValid, "fBm gain is clamped to (0, 1]");
+    
+    bool lacunaritiesValid = true;
+    for (float lacunarity : badLacunarities) {
+        parameters.setFbmLacunarity(lacunarity);
+        float clamped = parameters.getFbmLacunarity();
+        lacunaritiesValid = lacunaritiesValid && clamped >= NoiseGenerator::MIN_FBM_LACUNARITY &&
+                            clamped <= NoiseGenerator::MAX_FBM_LACUNARITY;
+    }
+    TestRunner::check(lacunaritiesValid, "fBm lacunarity is clamped to [1, " +
+                      ofToString(NoiseGenerator::MAX_FBM_LACUNARITY) + "]");
+    
+    parameters.setFbmGain(0.8f);
+    parameters.setFbmLacunarity(2.5f);
+    TestRunner::check(parameters.getFbmGain() == 0.8f && parameters.getFbmLacunarity() == 2.5f,
+                      "fBm settings in range are kept as they are");
+}
+
+}
+
+void runParameterManagerTests() {
+    testFbmSettingsAreClamped();
+}
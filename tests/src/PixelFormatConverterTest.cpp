@@ -0,0 +1,98 @@
+#include "TestRunner.h"
+#include "PixelFormatConverter.h"
+
+namespace {
+
+// Capture sizes, plus small ones whose widths leave a vector tail (odd for
+// the planar format) and whose rows are padded, to check the edge handling
+struct Case {
+    int width;
+    int height;
+    int padding;
+};
+
+const Case CASES[] = {{720, 576, 0}, {1280, 720, 0}, {1920, 1080, 0}, {714, 9, 24}, {33, 7, 6}};
+const ofPixelFormat FORMATS[] = {OF_PIXELS_YUY2, OF_PIXELS_UYVY, OF_PIXELS_NV12};
+
+const char* getFormatName(ofPixelFormat format) {
+    switch (format) {
+        case OF_PIXELS_YUY2: return "YUYV";
+        case OF_PIXELS_UYVY: return "UYVY";
+        case OF_PIXELS_NV12: return "NV12";
+        default: return "unknown";
+    }
+}
+
+int getStride(ofPixelFormat format, const Case& size) {
+    // Packed rows hold whole macropixels
+    int rowBytes = (format == OF_PIXELS_NV12) ? size.width : (size.width + 1) / 2 * 4;
+    return rowBytes + size.padding;
+}
+
+// Deterministic noise covers every Y/U/V combination's clamping
+std::vector<unsigned char> makeFrame(ofPixelFormat format, const Case& size) {
+    std::vector<unsigned char> frame(PixelFormatConverter::getFrameSize(format, getStride(format, size), size.height));
+    uint32_t seed = 12345;
+    for (auto& byte : frame) {
+        seed = seed * 1664525 + 1013904223;
+        byte = seed >> 24;
+    }
+    return frame;
+}
+
+// The vector kernel must match the scalar reference byte for byte
+void testVectorMatchesScalar() {
+    for (ofPixelFormat format : FORMATS) {
+        for (const Case& size : CASES) {
+            std::vector<unsigned char> frame = makeFrame(format, size);
+            int stride = getStride(format, size);
+            std::vector<unsigned char> reference((size_t)size.width * size.height * 4);
+            std::vector<unsigned char> converted(reference.size());
+            PixelFormatConverter::toRgbaScalar(format, frame.data(), stride, reference.data(), size.width, size.height);
+            PixelFormatConverter::toRgba(format, frame.data(), stride, converted.data(), size.width, size.height);
+            
+            int mismatches = 0;
+            for (size_t i = 0; i < reference.size(); i++) {
+                if (converted[i] != reference[i]) mismatches++;
+            }
+            TestRunner::check(mismatches == 0, std::string(getFormatName(format)) + " " +
+                              ofToString(size.width) + "x" + ofToString(size.height) + ": " +
+                              PixelFormatConverter::getKernelName() + " kernel matches scalar (" +
+                              ofToString(mismatches) + " bytes differ)");
+        }
+    }
+}
+
+void benchmarkConversion() {
+    const int runs = 10;
+    
+    for (ofPixelFormat format : FORMATS) {
+        for (const Case& size : CASES) {
+            if (size.padding > 0) continue;
+            std::vector<unsigned char> frame = makeFrame(format, size);
+            int stride = getStride(format, size);
+            std::vector<unsigned char> converted((size_t)size.width * size.height * 4);
+            
+            uint64_t scalarMicros = TestRunner::timeBest(runs, [&] {
+                PixelFormatConverter::toRgbaScalar(format, frame.data(), stride, converted.data(), size.width, size.height);
+            });
+            uint64_t vectorMicros = TestRunner::timeBest(runs, [&] {
+                PixelFormatConverter::toRgba(format, frame.data(), stride, converted.data(), size.width, size.height);
+            });
+            ofLogNotice("PixelFormatConverter") << getFormatName(format) << " " << size.width << "x" << size.height
+                                                << ": scalar " << scalarMicros / 1000.0f << "ms, "
+                                                << PixelFormatConverter::getKernelName() << " "
+                                                << vectorMicros / 1000.0f << "ms, best of " << runs;
+        }
+    }
+}
+
+}
+
+void runPixelFormatConverterTests() {
+    testVectorMatchesScalar();
+    
+    if (TestRunner::isBenchmarking()) {
+        benchmarkConversion();
+    }
+}
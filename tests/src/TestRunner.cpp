@@ -0,0 +1,46 @@
+#include "TestRunner.h"
+
+namespace {
+
+int checks = 0;
+int failures = 0;
+bool benchmarking = false;
+
+}
+
+bool TestRunner::check(bool passed, const std::string& description) {
+    checks++;
+    if (passed) {
+        ofLogNotice("TestRunner") << "ok: " << description;
+    } else {
+        failures++;
+        ofLogError("TestRunner") << "FAILED: " << description;
+    }
+    return passed;
+}
+
+int TestRunner::getChecks() {
+    return checks;
+}
+
+int TestRunner::getFailures() {
+    return failures;
+}
+
+void TestRunner::setBenchmarking(bool enabled) {
+    benchmarking = enabled;
+}
+
+bool TestRunner::isBenchmarking() {
+    return benchmarking;
+}
+
+uint64_t TestRunner::timeBest(int runs, const std::function<void()>& function) {
+    uint64_t best = std::numeric_limits<uint64_t>::max();
+    for (int run = 0; run < runs; run++) {
+        uint64_t start = ofGetElapsedTimeMicros();
+        function();
+        best = std::min(best, ofGetElapsedTimeMicros() - start);
+    }
+    return best;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "ofMain.h"
+
+// Shared state of the test executable. Tests report through check(), and
+// any failed check makes the executable exit non-zero. Timings only run
+// with --benchmark, so the default run stays quick enough for CI
+class TestRunner {
+public:
+    // Log the outcome; returns `passed` so callers can skip dependent checks
+    static bool check(bool passed, const std::string& description);
+    static int getChecks();
+    static int getFailures();
+    
+    static void setBenchmarking(bool enabled);
+    static bool isBenchmarking();
+    
+    // Fastest of `runs` calls, in microseconds
+    static uint64_t timeBest(int runs, const std::function<void()>& function);
+};
+
+// Test suites, one per tested source file. The GL suites need a context
+void runMeshGeneratorTests();
+void runNoiseGeneratorTests();
+void runNoiseVolumeTests();
+void runParameterManagerTests();
+void runPixelFormatConverterTests();
+void runV4L2HelperTests();
+void runMeshGeneratorGlTests();
+void runNoiseVolumeGlTests();
+void runAllocationTests();
@@ -0,0 +1,145 @@
+#include "TestRunner.h"
+#include "V4L2Helper.h"
+
+namespace {
+
+// The FourCC names the log and the debug overlay show
+void testFourCC() {
+    TestRunner::check(V4L2Helper::formatCodeToFourCC(0x56595559) == "YUYV" &&
+                      V4L2Helper::formatCodeToFourCC(0x47504A4D) == "MJPG",
+                      "pixel format codes print as their FourCC");
+}
+
+#ifdef TARGET_LINUX
+// vivid, the kernel's virtual video driver, stands in for a camera, so the
+// capture path can be checked on any Linux machine after
+// `sudo modprobe vivid`. Its nodes are found by driver name, since the
+// /dev/video numbers depend on what else is plugged in
+std::vector<std::string> findVividCaptureDevices() {
+    std::vector<std::string> paths;
+    for (const auto& device : V4L2Helper::listDevices()) {
+        int fd = ::open(device.path.c_str(), O_RDWR);
+        if (fd < 0) continue;
+        
+        struct v4l2_capability cap;
+        memset(&cap, 0, sizeof(cap));
+        if (ioctl(fd, VIDIOC_QUERYCAP, &cap) >= 0) {
+            uint32_t caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS) ? cap.device_caps : cap.capabilities;
+            if (std::string(reinterpret_cast<const char*>(cap.driver)) == "vivid" &&
+                (caps & V4L2_CAP_VIDEO_CAPTURE) && (caps & V4L2_CAP_STREAMING)) {
+                paths.push_back(device.path);
+            }
+        }
+        ::close(fd);
+    }
+    return paths;
+}
+
+// Control id by name; vivid's test controls have no public ids
+uint32_t findControl(int fd, const std::string& name) {
+    struct v4l2_queryctrl query;
+    memset(&query, 0, sizeof(query));
+    query.id = V4L2_CTRL_FLAG_NEXT_CTRL;
+    while (ioctl(fd, VIDIOC_QUERYCTRL, &query) >= 0) {
+        if (name == reinterpret_cast<const char*>(query.name)) return query.id;
+        query.id |= V4L2_CTRL_FLAG_NEXT_CTRL;
+    }
+    return 0;
+}
+
+// Grab up to `count` frames one at a time, handing each back at once;
+// returns the sequence numbers that arrived
+std::vector<uint32_t> grabSequences(V4L2Capture& capture, int count, bool& complete) {
+    std::vector<uint32_t> sequences;
+    complete = true;
+    for (int i = 0; i < count; i++) {
+        V4L2Capture::Frame frame;
+        if (!capture.grabFrame(frame, 1000)) break;
+        sequences.push_back(frame.sequence);
+        if (frame.bytesUsed < (size_t)capture.getBytesPerLine() * capture.getHeight()) complete = false;
+        capture.releaseFrame(frame);
+    }
+    return sequences;
+}
+
+// Open (S_FMT, REQBUFS, mmap, STREAMON), DQBUF and close, then open again,
+// which only works if close() released the driver buffers
+void testCapture(const std::string& path) {
+    V4L2Capture capture;
+    bool opened = capture.open(path, V4L2_PIX_FMT_YUYV, 640, 480, 30);
+    if (!TestRunner::check(opened, path + " streams YUYV through mmap buffers")) return;
+    TestRunner::check(capture.getNumBuffers() >= 2 && capture.getBytesPerLine() >= capture.getWidth() * 2,
+                      ofToString(capture.getNumBuffers()) + " buffers of " + ofToString(capture.getWidth()) + "x" +
+                      ofToString(capture.getHeight()) + " at " + ofToString(capture.getBytesPerLine()) + " bytes per line");
+    
+    bool complete;
+    std::vector<uint32_t> sequences = grabSequences(capture, 10, complete);
+    bool ordered = std::is_sorted(sequences.begin(), sequences.end()) &&
+                   std::adjacent_find(sequences.begin(), sequences.end()) == sequences.end();
+    TestRunner::check(sequences.size() == 10 && complete && ordered, ofToString(sequences.size()) +
+                      " of 10 frames dequeued whole and in sequence order");
+    
+    capture.close();
+    TestRunner::check(!capture.isOpen(), path + " stops streaming on close");
+    TestRunner::check(capture.open(path, V4L2_PIX_FMT_YUYV, 640, 480, 30), path + " opens again after close");
+}
+
+// vivid can flag the next buffer with V4L2_BUF_FLAG_ERROR on request.
+// grabFrame() must requeue it unseen, which leaves a gap in the sequence
+// numbers, and keep streaming
+void testErrorFramesSkipped(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDWR);
+    uint32_t control = fd >= 0 ? findControl(fd, "Inject V4L2_BUF_FLAG_ERROR") : 0;
+    if (control == 0) {
+        ofLogNotice("V4L2Helper") << path << " can't inject buffer errors, skipping that check";
+        if (fd >= 0) ::close(fd);
+        return;
+    }
+    
+    V4L2Capture capture;
+    bool complete;
+    std::vector<uint32_t> before;
+    if (capture.open(path, V4L2_PIX_FMT_YUYV, 640, 480, 30)) {
+        before = grabSequences(capture, 1, complete);
+    }
+    
+    if (!before.empty()) {
+        struct v4l2_control press;
+        memset(&press, 0, sizeof(press));
+        press.id = control;
+        press.value = 1;
+        ioctl(fd, VIDIOC_S_CTRL, &press);
+        
+        std::vector<uint32_t> sequences = grabSequences(capture, 10, complete);
+        int gaps = 0;
+        uint32_t previous = before[0];
+        for (uint32_t sequence : sequences) {
+            if (sequence != previous + 1) gaps++;
+            previous = sequence;
+        }
+        TestRunner::check(sequences.size() == 10 && gaps > 0, "a buffer flagged V4L2_BUF_FLAG_ERROR is skipped (" +
+                          ofToString(sequences.size()) + " of 10 frames after it, " + ofToString(gaps) + " sequence gaps)");
+    } else {
+        TestRunner::check(false, path + " streams frames for the error check");
+    }
+    ::close(fd);
+}
+#endif
+
+}
+
+void runV4L2HelperTests() {
+    testFourCC();
+    
+#ifdef TARGET_LINUX
+    std::vector<std::string> paths = findVividCaptureDevices();
+    if (paths.empty()) {
+        ofLogNotice("V4L2Helper") << "No vivid capture device, skipping the capture checks (sudo modprobe vivid)";
+        return;
+    }
+    testCapture(paths[0]);
+    testErrorFramesSkipped(paths[0]);
+#else
+    ofLogNotice("V4L2Helper") << "Native capture is only available on Linux, skipping the capture checks";
+#endif
+}
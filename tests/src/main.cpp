@@ -0,0 +1,50 @@
+#include "ofMain.h"
+#include "TestRunner.h"
+
+//========================================================================
+// Runs every suite and exits non-zero if any check failed.
+//   --benchmark  also time the kernels and log the results
+//   --no-gl      skip the suites that need a GL context (e.g. headless CI)
+int main(int argc, char* argv[]) {
+    bool useGl = true;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--benchmark") {
+            TestRunner::setBenchmarking(true);
+        } else if (argument == "--no-gl") {
+            useGl = false;
+        } else {
+            ofLogError("main") << "Unknown option " << argument << ", expected --benchmark or --no-gl";
+            return 2;
+        }
+    }
+    
+    runMeshGeneratorTests();
+    runNoiseGeneratorTests();
+    runNoiseVolumeTests();
+    runParameterManagerTests();
+    runPixelFormatConverterTests();
+    runV4L2HelperTests();
+    
+    if (useGl) {
+        // A window only for its GL context; the main loop never runs
+        #if (defined(__arm__) || defined(__aarch64__)) && !defined(__APPLE__)
+            ofGLESWindowSettings settings;
+            settings.glesVersion = 2;
+        #else
+            ofGLFWWindowSettings settings;
+            settings.setGLVersion(3, 2);
+            settings.visible = false;
+        #endif
+        settings.setSize(640, 480);
+        auto window = ofCreateWindow(settings);
+        
+        runMeshGeneratorGlTests();
+        runNoiseVolumeGlTests();
+        runAllocationTests();
+    }
+    
+    ofLogNotice("main") << TestRunner::getChecks() - TestRunner::getFailures() << " of "
+                        << TestRunner::getChecks() << " checks passed";
+    return TestRunner::getFailures() > 0 ? 1 : 0;
+}